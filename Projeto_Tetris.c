@@ -1,13 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
-#include "hardware/adc.h"
-#include "hardware/gpio.h"
+#include <string.h>
+#include "hal.h"
 #include "auto_repeat.h"
+#include "input_events.h"
 #include "ssd1306.h"
 #include "tetris.h"
 #include "buzzer.h"
+#include "input_log.h"
+#include "prof.h"
+#include "frame_clock.h"
+#include "render_core.h"
+#include "tetris_ai.h"
+#include "idle_sched.h"
+#include "anim.h"
 
 
 // Mapeamento
@@ -16,6 +22,8 @@
 #define JOY_BUT_PIN 22 // joystick push
 #define JOY_VRX_PIN 27 // ADC1
 #define JOY_VRY_PIN 26 // ADC0
+#define JOY_VRX_ADC 1
+#define JOY_VRY_ADC 0
 
 #define LED_R_PIN  13
 #define LED_G_PIN  11
@@ -23,159 +31,392 @@
 
 #define I2C_SDA    14
 #define I2C_SCL    15
-#define I2C_PORT   i2c1
+#define I2C_BUS    1  // i2c1
 #define OLED_ADDR  0x3C
 #define OLED_W     128
 #define OLED_H     64
 
-// Variável global do display
+// Sorteio das peças; a semente de cada partida vem de hal_random_seed()
+#define GAME_RANDOMIZER  PIECE_RANDOM_BAG
+#define GAME_20G         false // true: partidas em 20G desde a primeira peça
+
+// Simulação em passo fixo; render e entrada uma vez por frame
+#define SIM_STEP_MS      10
+#define FRAME_PERIOD_US  33000 // ~30 fps, também o orçamento de trabalho do frame
+#define STATS_EVERY      300   // frames entre impressões das estatísticas
+
+// Modo demonstração (botão A pressionado ao ligar): tetris_ai joga sozinho
+#define AI_DEPTH         2
+
+// Variável global do display (do core1 depois de render_core_start)
 ssd1306_t g_oled_dev;
 
-// AutoRepeat para cada botão, se quiser
-static AutoRepeat ar_butA, ar_butB;
-static AutoRepeat ar_joyBut;
-static uint32_t last_time=0;
+// Estado da partida
+static TetrisGame game;
+
+// Gravação das entradas da partida atual (despejada no game over)
+static InputLog input_log;
+
+// DAS/ARR de cada ação (índice = bit TETRIS_ACTION_*), alimentado pelos
+// instantes das bordas dos botões e das zonas do joystick
+static AutoRepeat repeaters[TETRIS_NUM_ACTIONS];
+
+static const AutoRepeatConfig REPEAT_BUTTON= {   // giros e hard drop
+    .das_us= 200000, .arr_us= 200000, .hold_us= 1000000, .arr_hold_us= 66000, .max_burst= 1,
+};
+static const AutoRepeatConfig REPEAT_SHIFT= {    // esquerda/direita
+    .das_us= 133000, .arr_us= 33000, .max_burst= TETRIS_WIDTH,
+};
+static const AutoRepeatConfig REPEAT_SOFT_DROP= {
+    .das_us= 33000, .arr_us= 33000, .max_burst= 4,
+};
+
+// Passo fixo da simulação + orçamento do frame
+static FrameClock frame_clock;
+
+// Espera entre frames até o próximo prazo (ver idle_sched.h)
+static IdleSched idle;
+
+// Animações dos frames seguintes: linhas piscando, LEDs, tons, banner
+static Anim anim;
+
+// Linhas completas piscam duas vezes antes do colapso, com o LED verde
+#define CLEAR_FLASH_US 50000
+static const AnimTrack LINE_CLEAR_ANIM[]= {
+    { .target= ANIM_ROWS, .count= 2, .on_us= CLEAR_FLASH_US, .off_us= CLEAR_FLASH_US }, // arg = linhas
+    { .target= ANIM_LED,  .count= 2, .on_us= CLEAR_FLASH_US, .off_us= CLEAR_FLASH_US, .arg= LED_G_PIN },
+};
+
+// Game over: LED vermelho e tom de 200 Hz três vezes, placar na tela até
+// a próxima partida começar
+static const AnimTrack GAME_OVER_ANIM[]= {
+    { .target= ANIM_LED,    .count= 3, .on_us= 200000, .off_us= 300000, .arg= LED_R_PIN },
+    { .target= ANIM_TONE,   .count= 3, .delay_us= 400000, .on_us= 100000, .off_us= 400000, .arg= 200 },
+    { .target= ANIM_BANNER, .count= 1, .on_us= 2000000 },
+};
+
+// Clock reduzido pedido (game over) e o que está em uso (ver sync_clock)
+static bool want_reduced_clock= false;
+static bool reduced_clock= false;
+
+// Geração do último snapshot aceito pelo core1 (tetris_generation e anim_generation)
+static uint32_t drawn_generation;
+static uint32_t drawn_anim;
+static bool     drawn_valid= false;
+
+static bool ai_mode = false;
+static TetrisAiConfig ai_cfg;
+static TetrisAi ai;
+
+// Partida nova e a gravação dela, com o modo de jogo no cabeçalho do log
+static void begin_game(uint32_t seed){
+    tetris_init(&game, seed, GAME_RANDOMIZER);
+    tetris_set_20g(&game, GAME_20G);
+    input_log_begin(&input_log, seed, GAME_RANDOMIZER, ai_mode ? AI_DEPTH : 0);
+    if(GAME_20G) input_log.header.flags |= INPUT_LOG_FLAG_20G;
+}
+
+// Entrada: eventos da fila de input_events (IRQ) -> auto-repeat de cada
+// ação -> disparos pendentes, aplicados uma vez por frame
+
+// Disparos pendentes de cada ação neste frame
+static uint8_t pending[TETRIS_NUM_ACTIONS];
 
-// Funções de callback ou polling
-// Exemplo: ler estado e chamar tetris_xxx
+// Último instante passado a cada repeater
+static uint64_t fed_us[TETRIS_NUM_ACTIONS];
+
+static void feed(uint8_t action, uint64_t t_us, bool pressed){
+    int i= __builtin_ctz(action);
+    // um botão publicado no fim do debounce traz o instante da borda, que
+    // pode ser de antes do input_us do frame anterior: o tempo não volta
+    if(t_us < fed_us[i]) t_us= fed_us[i];
+    fed_us[i]= t_us;
+    pending[i]+= (uint8_t)auto_repeat_update(&repeaters[i], t_us, pressed);
+}
+
+// Evento de entrada -> ações; vy baixo = esquerda, vx alto = soft drop
+static void feed_event(const InputEvent *ev){
+    switch(ev->source){
+    case INPUT_BUTTON_A:   feed(TETRIS_ACTION_ROT_CCW, ev->time_us, ev->value); break; // anti-horário
+    case INPUT_BUTTON_B:   feed(TETRIS_ACTION_ROT_CW, ev->time_us, ev->value); break;  // horário
+    case INPUT_BUTTON_JOY: feed(TETRIS_ACTION_HARD_DROP, ev->time_us, ev->value); break;
+    case INPUT_AXIS_X:
+        feed(TETRIS_ACTION_SOFT_DROP, ev->time_us, ev->value>0);
+        feed(TETRIS_ACTION_ROT_CW_JOY, ev->time_us, ev->value<0);
+        break;
+    case INPUT_AXIS_Y:
+        feed(TETRIS_ACTION_LEFT, ev->time_us, ev->value<0);
+        feed(TETRIS_ACTION_RIGHT, ev->time_us, ev->value>0);
+        break;
+    }
+}
+
+// Tira um disparo de cada ação pendente; 0 quando não sobra nenhum
+static uint8_t take_actions(void){
+    uint8_t actions= 0;
+    for(int i=0; i<TETRIS_NUM_ACTIONS; i++){
+        if(pending[i]){
+            pending[i]--;
+            actions|= (uint8_t)(1u<<i);
+        }
+    }
+    return actions;
+}
+
+// Toca nos dois buzzers os sons dos eventos da partida
+static void play_events(uint8_t events){
+    if(events & TETRIS_EVENT_LINES){
+        // Toca um tom mais longo ao completar linha(s)
+        buzzer_a_play_tone(600, 150);
+        buzzer_b_play_tone(600, 150);
+    } else if(events & TETRIS_EVENT_LOCK){
+        buzzer_a_play_tone(300, 50);
+        buzzer_b_play_tone(300, 50);
+    } else if(events & (TETRIS_EVENT_MOVE | TETRIS_EVENT_ROTATE)){
+        // Som ao mover/girar
+        buzzer_a_beep();
+        buzzer_b_beep();
+    }
+}
+
+// Começa as animações dos eventos do frame
+static void start_animations(uint8_t events, uint64_t now_us){
+    // outra trava: o tabuleiro de antes do colapso não vale mais
+    if(events & TETRIS_EVENT_LOCK) anim_cancel(&anim, ANIM_ROWS);
+    if((events & TETRIS_EVENT_LINES) && game.cleared_rows){
+        AnimTrack tracks[2];
+        memcpy(tracks, LINE_CLEAR_ANIM, sizeof(tracks));
+        tracks[0].arg= game.cleared_rows;
+        anim_start(&anim, tracks, 2, now_us);
+    }
+    if(events & TETRIS_EVENT_GAME_OVER){
+        anim_start(&anim, GAME_OVER_ANIM, 3, now_us);
+        // até a próxima partida o laço só anima e espera
+        want_reduced_clock= true;
+    }
+}
+
+// Aplica o clock pedido quando dá: a troca muda a base do I2C e do PWM,
+// então espera o core1 terminar os envios e os buzzers se calarem
+static bool sync_clock(void){
+    if(reduced_clock == want_reduced_clock) return true;
+    if(buzzer_busy(BUZZER_A) || buzzer_busy(BUZZER_B) || !render_core_idle()) return false;
+    hal_set_clock_reduced(want_reduced_clock);
+    reduced_clock= want_reduced_clock;
+    return true;
+}
+
+// O core1 já recebeu o estado visível atual (partida + animações)
+static bool frame_drawn(void){
+    return drawn_valid && tetris_generation(&game) == drawn_generation
+        && anim_generation(&anim) == drawn_anim;
+}
 
 int main(void){
-    stdio_init_all();
-    sleep_ms(2000);
+    hal_init();
+    hal_sleep_ms(2000);
 
     // init GPIO (botões)
-    gpio_init(BUT_A_PIN);
-    gpio_set_dir(BUT_A_PIN, GPIO_IN);
-    gpio_pull_up(BUT_A_PIN);
-
-    gpio_init(BUT_B_PIN);
-    gpio_set_dir(BUT_B_PIN, GPIO_IN);
-    gpio_pull_up(BUT_B_PIN);
+    hal_gpio_init_input(BUT_A_PIN, true);
+    hal_gpio_init_input(BUT_B_PIN, true);
 
     // Joystick button
-    gpio_init(JOY_BUT_PIN);
-    gpio_set_dir(JOY_BUT_PIN, GPIO_IN);
-    gpio_pull_up(JOY_BUT_PIN);
+    hal_gpio_init_input(JOY_BUT_PIN, true);
 
     // LED RGB (saída)
-    gpio_init(LED_R_PIN);
-    gpio_set_dir(LED_R_PIN, GPIO_OUT);
-    gpio_put(LED_R_PIN,false);
-
-    gpio_init(LED_G_PIN);
-    gpio_set_dir(LED_G_PIN, GPIO_OUT);
-    gpio_put(LED_G_PIN,false);
-
-    gpio_init(LED_B_PIN);
-    gpio_set_dir(LED_B_PIN, GPIO_OUT);
-    gpio_put(LED_B_PIN,false);
+    hal_gpio_init_output(LED_R_PIN, false);
+    hal_gpio_init_output(LED_G_PIN, false);
+    hal_gpio_init_output(LED_B_PIN, false);
 
     // ADC Joystick
-    adc_init();
-    adc_gpio_init(JOY_VRX_PIN); // ADC1
-    adc_gpio_init(JOY_VRY_PIN); // ADC0
+    hal_adc_init();
+    hal_adc_gpio_init(JOY_VRX_PIN); // ADC1
+    hal_adc_gpio_init(JOY_VRY_PIN); // ADC0
 
     // I2C + SSD1306
-    i2c_init(I2C_PORT, 400000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+    hal_i2c_init(I2C_BUS, 400000, I2C_SDA, I2C_SCL);
 
     // init display
     ssd1306_init(&g_oled_dev, OLED_W,OLED_H,
                  false, // external_vcc
-                 OLED_ADDR, I2C_PORT);
+                 OLED_ADDR, I2C_BUS);
     ssd1306_config(&g_oled_dev);
 
+    // core1: composição do framebuffer e envio I2C
+    render_core_start(&g_oled_dev);
+
     // Inicializa os buzzers
     buzzer_a_init();
     buzzer_b_init();
 
 
+    // modo demonstração se o botão A estiver pressionado ao ligar
+    ai_mode= (hal_gpio_get(BUT_A_PIN)==0);
+    tetris_ai_default_config(&ai_cfg, AI_DEPTH);
+    tetris_ai_init(&ai, &ai_cfg);
+
     // init tetris
-    tetris_init();
+    uint32_t seed= hal_random_seed();
+    begin_game(seed);
 
     // autoRepeat
-    auto_repeat_init(&ar_butA, 200,1000);
-    auto_repeat_init(&ar_butB, 200,1000);
-    auto_repeat_init(&ar_joyBut, 200,1000);
-
-    last_time= to_ms_since_boot(get_absolute_time());
-
-    while(true){
-        // tempo
-        uint32_t now= to_ms_since_boot(get_absolute_time());
-        uint32_t dt= now- last_time;
-        last_time= now;
+    for(int i=0; i<TETRIS_NUM_ACTIONS; i++){
+        auto_repeat_init(&repeaters[i], &REPEAT_BUTTON);
+    }
+    auto_repeat_init(&repeaters[__builtin_ctz(TETRIS_ACTION_LEFT)], &REPEAT_SHIFT);
+    auto_repeat_init(&repeaters[__builtin_ctz(TETRIS_ACTION_RIGHT)], &REPEAT_SHIFT);
+    auto_repeat_init(&repeaters[__builtin_ctz(TETRIS_ACTION_SOFT_DROP)], &REPEAT_SOFT_DROP);
+
+    // bordas dos botões e joystick por IRQ/DMA (ver input_events.h)
+    InputConfig input_cfg= {
+        .button_pins= { [INPUT_BUTTON_A]= BUT_A_PIN, [INPUT_BUTTON_B]= BUT_B_PIN,
+                        [INPUT_BUTTON_JOY]= JOY_BUT_PIN },
+        .axis_inputs= { [INPUT_AXIS_X - INPUT_NUM_BUTTONS]= JOY_VRX_ADC,
+                        [INPUT_AXIS_Y - INPUT_NUM_BUTTONS]= JOY_VRY_ADC },
+    };
+    input_events_init(&input_cfg);
+
+    frame_clock_init(&frame_clock, SIM_STEP_MS * 1000, FRAME_PERIOD_US, hal_time_us());
+    idle_sched_init(&idle, hal_time_us());
+    anim_init(&anim);
+
+    while(hal_running()){
+        // tempo: quantos passos fixos couberam desde o último frame
+        uint64_t frame_us= hal_time_us();
+        uint32_t steps= frame_clock_begin(&frame_clock, frame_us);
+        uint32_t dt= steps * SIM_STEP_MS;
+        // depois do game over as entradas ainda são lidas, mas não vão ao log
+        bool playing= !tetris_is_game_over(&game);
 
         // update tetris
-        tetris_update(dt);
-
-        // Leitura botões
-        bool a_state= (gpio_get(BUT_A_PIN)==0);
-        bool b_state= (gpio_get(BUT_B_PIN)==0);
-        bool joy_but= (gpio_get(JOY_BUT_PIN)==0);
-
-        // auto-repeat
-        if(auto_repeat_next(&ar_butA, now, a_state)){
-            // anti-horário
-            tetris_rotate_counter();
+        PROF_BEGIN(PROF_UPDATE);
+        for(uint32_t i=0; i<steps; i++){
+            tetris_update(&game, SIM_STEP_MS);
         }
-        if(auto_repeat_next(&ar_butB, now, b_state)){
-            // horário
-            tetris_rotate_clockwise();
+        PROF_END(PROF_UPDATE);
+
+        // Entradas: bordas e zonas chegam por IRQ com o próprio instante;
+        // um toque mais curto que o frame ainda gera a ação
+        PROF_BEGIN(PROF_INPUT);
+        InputEvent ev;
+        while(input_events_pop(&ev)){
+            feed_event(&ev);
         }
-        if(auto_repeat_next(&ar_joyBut, now, joy_but)){
-            // Podíamos usar para "hard_drop" ou togglar LED
-            tetris_hard_drop();
+        // repetições vencidas até agora; o instante é lido depois da fila,
+        // nunca antes do último evento dela
+        uint64_t input_us= hal_time_us();
+        for(int i=0; i<TETRIS_NUM_ACTIONS; i++){
+            feed((uint8_t)(1u<<i), input_us, repeaters[i].pressed);
         }
-
-        // Ler joystick ADC
-        // VRX => ADC1
-        adc_select_input(1);
-        uint16_t vx= adc_read();
-        // VRY => ADC0
-        adc_select_input(0);
-        uint16_t vy= adc_read();
-
-        // se vx<1000 => move left, >3000 => move right
-        if(vy<1000){
-            tetris_move_left();
-        } else if(vy>3000){
-            tetris_move_right();
+        PROF_END(PROF_INPUT);
+
+        // no modo demonstração a IA joga e os controles são ignorados
+        if(ai_mode && playing){
+            PROF_BEGIN(PROF_AI);
+            tetris_ai_step(&ai, &game);
+            PROF_END(PROF_AI);
+            memset(pending, 0, sizeof(pending));
         }
 
-        // se vy>3000 => soft drop
-        // se vy<1000 => rotate
-        if(vx>3000){
-            tetris_soft_drop();
-        } else if(vx<1000){
-            tetris_rotate_clockwise();
+        // Uma passada por disparo pendente (um frame atrasado pode ter
+        // vários movimentos); no log as passadas extras têm dt = 0
+        PROF_BEGIN(PROF_ACTIONS);
+        if(playing){
+            uint8_t actions= take_actions();
+            tetris_apply_actions(&game, actions);
+            input_log_record(&input_log, dt, actions);
+            while((actions= take_actions())){
+                tetris_apply_actions(&game, actions);
+                input_log_record(&input_log, 0, actions);
+            }
+        } else {
+            memset(pending, 0, sizeof(pending));
         }
-
-        // draw
-        tetris_draw(); // desenha no display
-
-        // se game_over => reinit
-        if(tetris_is_game_over()){
-            // piscar LED vermelho, etc.
-            for(int i=0;i<3;i++){
-                gpio_put(LED_R_PIN, true);
-                sleep_ms(200);
-                gpio_put(LED_R_PIN, false);
-                sleep_ms(200);
-                
-                // Toca um tom de 200Hz por 100ms em cada buzzer (A e B) – pode ser simultâneo ou em sequência
-                buzzer_a_play_tone(200, 100);
-                buzzer_b_play_tone(200, 100);
-                sleep_ms(100);
+        PROF_END(PROF_ACTIONS);
+
+        PROF_BEGIN(PROF_SOUND);
+        uint8_t events= tetris_take_events(&game);
+        play_events(events);
+        PROF_END(PROF_SOUND);
+
+        // animações no relógio do frame; custo limitado a ANIM_MAX_TRACKS
+        PROF_BEGIN(PROF_ANIM);
+        start_animations(events, frame_us);
+        anim_update(&anim, frame_us);
+        PROF_END(PROF_ANIM);
+
+        // entrega o estado ao core1, que desenha e envia ao display; sem
+        // mudança visível não há snapshot (o core1 fica dormindo), e o
+        // render é pulado se o frame já estourou o orçamento
+        if(frame_drawn()){
+            frame_clock_unchanged(&frame_clock);
+        } else if(frame_clock_should_render(&frame_clock, hal_time_us())){
+            PROF_BEGIN(PROF_SNAPSHOT);
+            TetrisSnapshot snap;
+            tetris_snapshot(&game, &snap);
+            anim_apply(&anim, &snap);
+            snap.seq= frame_clock_stats(&frame_clock)->frames;
+            snap.stamp_us= (uint32_t)frame_us;
+            // fila cheia: tenta de novo no próximo frame
+            if(render_core_submit(&snap)){
+                drawn_generation= tetris_generation(&game);
+                drawn_anim= anim_generation(&anim);
+                drawn_valid= true;
             }
-            printf("Game Over. Score=%u\n", tetris_get_score());
-            tetris_init();
+            PROF_END(PROF_SNAPSHOT);
         }
 
-        sleep_ms(50);
+        // game over: LEDs, tons e banner rodam nos frames seguintes
+        // (start_animations); quando acabam e o clock volta, log e partida nova
+        bool game_over_done= tetris_is_game_over(&game) && !anim_running(&anim);
+        if(game_over_done) want_reduced_clock= false;
+        bool clock_synced= sync_clock();
+        if(game_over_done && clock_synced){
+            printf("Game Over. Score=%u\n", (unsigned)tetris_get_score(&game));
+            input_log_finish(&input_log, tetris_get_score(&game), tetris_hash(&game));
+            input_log_dump(&input_log);
+            PROF_DUMP();
+            PROF_RESET();
+
+            seed= hal_random_seed();
+            begin_game(seed);
+            drawn_valid= false;
+            tetris_ai_init(&ai, &ai_cfg);
+
+            // o despejo pelo USB não conta como atraso da simulação
+            frame_clock_resync(&frame_clock, hal_time_us());
+        }
+
+        uint32_t idle_us= frame_clock_end(&frame_clock, hal_time_us());
+        if(frame_clock_stats(&frame_clock)->frames % STATS_EVERY == 0){
+            frame_clock_print(&frame_clock);
+            idle_sched_print(&idle, hal_time_us());
+            render_core_print();
+        }
+        // 'p' no terminal USB: perfil das etapas até agora
+        if(hal_getchar() == 'p') PROF_DUMP();
+
+        // Dorme até o primeiro prazo: o próximo frame só quando há o que
+        // fazer nele (IA, snapshot a reenviar, troca de clock pendente); senão o passo da gravidade,
+        // a próxima repetição de um controle apertado, a próxima transição
+        // de uma animação ou uma entrada nova
+        uint64_t now_us= hal_time_us();
+        if(ai_mode || !frame_drawn() || reduced_clock != want_reduced_clock){
+            idle_sched_at(&idle, IDLE_WAKE_FRAME, now_us + idle_us);
+        }
+        idle_sched_at(&idle, IDLE_WAKE_ANIM, anim_next_us(&anim));
+        uint32_t gravity_ms= tetris_gravity_due_ms(&game);
+        if(gravity_ms != UINT32_MAX){
+            idle_sched_at(&idle, IDLE_WAKE_GRAVITY,
+                          frame_clock_sim_deadline(&frame_clock, (uint64_t)gravity_ms * 1000));
+        }
+        for(int i=0; i<TETRIS_NUM_ACTIONS; i++){
+            idle_sched_at(&idle, IDLE_WAKE_REPEAT, auto_repeat_next_us(&repeaters[i]));
+        }
+        PROF_BEGIN(PROF_IDLE);
+        idle_sched_sleep(&idle, now_us, input_events_pending);
+        PROF_END(PROF_IDLE);
+        frame_clock_slept_until(&frame_clock, hal_time_us());
     }
 
     return 0;
@@ -0,0 +1,151 @@
+#include "anim.h"
+#include <string.h>
+#include "hal.h"
+#include "buzzer.h"
+
+static bool visual(uint8_t target) {
+    return target == ANIM_ROWS || target == ANIM_BANNER;
+}
+
+// Saída da trilha ao ligar/desligar
+static void output(Anim *a, AnimSlot *s, bool on) {
+    const AnimTrack *t = &s->track;
+    if(visual(t->target) && on != s->on) a->generation++;
+    s->on = on;
+    switch(t->target){
+    case ANIM_LED:
+        hal_gpio_put((uint8_t)t->arg, on);
+        break;
+    case ANIM_TONE:
+        if(on){
+            uint16_t ms = (uint16_t)(t->on_us / 1000);
+            buzzer_play(BUZZER_A, (uint16_t)t->arg, ms);
+            buzzer_play(BUZZER_B, (uint16_t)t->arg, ms);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void stop(Anim *a, AnimSlot *s) {
+    output(a, s, false);
+    if(visual(s->track.target)) a->generation++;
+    s->active = false;
+}
+
+void anim_init(Anim *a) {
+    memset(a, 0, sizeof(*a));
+}
+
+bool anim_start(Anim *a, const AnimTrack *tracks, int n, uint64_t now_us) {
+    int free_slots = 0;
+    for(int i=0; i<ANIM_MAX_TRACKS; i++){
+        if(!a->slots[i].active) free_slots++;
+    }
+    if(free_slots < n) return false;
+
+    int k = 0;
+    for(int i=0; i<ANIM_MAX_TRACKS && k<n; i++){
+        AnimSlot *s = &a->slots[i];
+        if(s->active) continue;
+        s->track    = tracks[k++];
+        s->start_us = now_us + s->track.delay_us;
+        s->cycle    = -1;
+        s->fired    = -1;
+        s->on       = false;
+        s->active   = true;
+        if(visual(s->track.target)) a->generation++;
+    }
+    return true;
+}
+
+void anim_cancel(Anim *a, AnimTarget target) {
+    for(int i=0; i<ANIM_MAX_TRACKS; i++){
+        AnimSlot *s = &a->slots[i];
+        if(s->active && s->track.target == target) stop(a, s);
+    }
+}
+
+bool anim_running(const Anim *a) {
+    for(int i=0; i<ANIM_MAX_TRACKS; i++){
+        if(a->slots[i].active) return true;
+    }
+    return false;
+}
+
+void anim_update(Anim *a, uint64_t now_us) {
+    for(int i=0; i<ANIM_MAX_TRACKS; i++){
+        AnimSlot *s = &a->slots[i];
+        if(!s->active || now_us < s->start_us) continue;
+        const AnimTrack *t = &s->track;
+        uint64_t period = (uint64_t)t->on_us + t->off_us;
+        uint64_t e = now_us - s->start_us;
+        uint64_t cycle = e / period;
+        if(cycle >= t->count){
+            stop(a, s);
+            continue;
+        }
+        bool on = e - cycle * period < t->on_us;
+        s->cycle = (int16_t)cycle;
+        // tom só na subida: um ciclo pulado inteiro não toca
+        if(on && s->fired != s->cycle){
+            s->fired = s->cycle;
+            output(a, s, true);
+        } else if(on != s->on){
+            output(a, s, on);
+        }
+    }
+}
+
+uint64_t anim_next_us(const Anim *a) {
+    uint64_t next = UINT64_MAX;
+    for(int i=0; i<ANIM_MAX_TRACKS; i++){
+        const AnimSlot *s = &a->slots[i];
+        if(!s->active) continue;
+        const AnimTrack *t = &s->track;
+        uint64_t at = s->start_us;
+        if(s->cycle >= 0){
+            // ligada: apaga em on_us; desligada: liga no próximo ciclo (ou termina)
+            uint64_t period = (uint64_t)t->on_us + t->off_us;
+            uint64_t base = s->start_us + (uint64_t)s->cycle * period;
+            at = s->on ? base + t->on_us : base + period;
+        }
+        if(at < next) next = at;
+    }
+    return next;
+}
+
+// Tabuleiro de antes do colapso: as linhas removidas voltam (cheias ou
+// vazias) e as de cima sobem de novo; vale enquanto não houver outra trava.
+// A peça seguinte já nasceu sobre o tabuleiro colapsado: fica escondida
+static void expand_rows(TetrisSnapshot *snap, uint32_t cleared, bool on) {
+    uint16_t rows[TETRIS_HEIGHT];
+    int src = TETRIS_HEIGHT - 1;
+    for(int y=TETRIS_HEIGHT-1; y>=0; y--){
+        if(cleared & (1u << y)){
+            rows[y] = on ? TETRIS_ROW_FULL : TETRIS_ROW_EMPTY;
+        } else {
+            rows[y] = src >= 0 ? snap->rows[src--] : TETRIS_ROW_EMPTY;
+        }
+    }
+    memcpy(snap->rows, rows, sizeof(rows));
+    snap->piece_hidden = true;
+}
+
+void anim_apply(const Anim *a, TetrisSnapshot *snap) {
+    for(int i=0; i<ANIM_MAX_TRACKS; i++){
+        const AnimSlot *s = &a->slots[i];
+        if(!s->active) continue;
+        switch(s->track.target){
+        case ANIM_ROWS:
+            expand_rows(snap, s->track.arg, s->on);
+            break;
+        case ANIM_BANNER:
+            if(s->on) snap->banner = true;
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris.h"
+
+/**
+ * Animações numa linha do tempo, sem bloquear o laço. Cada trilha é um
+ * pisca: começa delay_us depois de anim_start, fica ligada on_us e
+ * desligada off_us, 'count' vezes, e aciona um alvo (linhas piscando,
+ * LED, tom nos buzzers, banner do placar). Uma animação é um grupo de
+ * trilhas iniciadas juntas, e várias rodam ao mesmo tempo.
+ *
+ * O estado de cada trilha é função só do instante passado a anim_update
+ * (o início do frame): um frame atrasado pula para a fase certa sem
+ * recuperar as transições perdidas. O custo por frame é limitado por
+ * ANIM_MAX_TRACKS trilhas e, no snapshot, por uma passada nas linhas.
+ *
+ * As animações só mudam o que é desenhado, nunca a partida: o motor não
+ * espera por elas, e o replay de um TLOG não depende delas. ANIM_ROWS,
+ * portanto, pisca sobre um tabuleiro que o motor já colapsou, com a peça
+ * seguinte já em jogo. Enquanto pisca, o snapshot volta às linhas de antes
+ * do colapso e esconde a peça e a fantasma (piece_hidden); a peça segue
+ * caindo e aceitando comandos, e reaparece onde estiver no fim do pisca
+ * (200 ms em LINE_CLEAR_ANIM). Segurar o nascimento até o fim do pisca
+ * mudaria o tempo da partida. Uma nova trava cancela o pisca.
+ */
+
+#define ANIM_MAX_TRACKS 8
+
+typedef enum {
+    ANIM_ROWS = 0, // linhas removidas (arg = tetris cleared_rows): cheias/vazias antes do colapso
+    ANIM_LED,      // LED no pino arg
+    ANIM_TONE,     // tom de arg Hz nos dois buzzers, on_us de duração, a cada vez que liga
+    ANIM_BANNER,   // banner do placar por cima do tabuleiro
+    ANIM_NUM_TARGETS
+} AnimTarget;
+
+typedef struct {
+    uint8_t  target;   // AnimTarget
+    uint8_t  count;    // ciclos liga/desliga (> 0)
+    uint32_t delay_us; // desde anim_start
+    uint32_t on_us;    // > 0
+    uint32_t off_us;
+    uint32_t arg;
+} AnimTrack;
+
+typedef struct {
+    AnimTrack track;
+    uint64_t  start_us; // início do primeiro ciclo
+    int16_t   cycle;    // ciclo no último anim_update (-1 = ainda não começou)
+    int16_t   fired;    // ciclo em que a trilha ligou pela última vez
+    bool      active;
+    bool      on;
+} AnimSlot;
+
+typedef struct {
+    AnimSlot slots[ANIM_MAX_TRACKS];
+    uint32_t generation; // muda quando o que vai no snapshot muda
+} Anim;
+
+void anim_init(Anim *a);
+
+/** Inicia as n trilhas em now_us; false (e nada inicia) se não houver slots para todas. */
+bool anim_start(Anim *a, const AnimTrack *tracks, int n, uint64_t now_us);
+
+/** Para as trilhas do alvo (LEDs apagam). */
+void anim_cancel(Anim *a, AnimTarget target);
+
+/** true enquanto houver trilha ativa (de qualquer alvo). */
+bool anim_running(const Anim *a);
+
+/** Avança até now_us: acende/apaga LEDs e dispara tons nas transições. */
+void anim_update(Anim *a, uint64_t now_us);
+
+/** Próximo instante em que alguma trilha muda; UINT64_MAX se nenhuma. */
+uint64_t anim_next_us(const Anim *a);
+
+/** Igual entre dois frames => o snapshot sai igual (ver tetris_generation). */
+static inline uint32_t anim_generation(const Anim *a) { return a->generation; }
+
+/** Aplica as trilhas visuais ao snapshot do frame. */
+void anim_apply(const Anim *a, TetrisSnapshot *s);
+
+#endif
@@ -1,56 +1,47 @@
 #include "auto_repeat.h"
 
-void auto_repeat_init(AutoRepeat *ar,
-                      uint32_t repeat_time,
-                      uint32_t hold_time)
+void auto_repeat_init(AutoRepeat *ar, const AutoRepeatConfig *cfg)
 {
     if(!ar) return;
-    ar->repeat_time = repeat_time;
-    ar->hold_time   = hold_time;
-    ar->pressed     = false;
-    ar->last_state  = false;
-    ar->pressed_time= 0;
-    ar->last_time   = 0;
+    ar->cfg        = *cfg;
+    ar->pressed    = false;
+    ar->pressed_us = 0;
+    ar->next_us    = 0;
 }
 
-bool auto_repeat_next(AutoRepeat *ar,
-                      uint32_t time_ms,
-                      bool current_state)
+static uint32_t interval(const AutoRepeat *ar, uint64_t at_us)
 {
-    if(!ar) return false;
+    const AutoRepeatConfig *c = &ar->cfg;
+    if(c->hold_us && at_us - ar->pressed_us >= c->hold_us) return c->arr_hold_us;
+    return c->arr_us;
+}
 
-    bool changed = (current_state != ar->last_state);
-    ar->last_state = current_state;
+uint32_t auto_repeat_update(AutoRepeat *ar, uint64_t t_us, bool pressed)
+{
+    if(!ar) return 0;
+    uint32_t fired = 0;
+    uint32_t burst = ar->cfg.max_burst ? ar->cfg.max_burst : 1;
 
-    if(changed) {
-        if(current_state) {
-            // pressionou agora
-            ar->pressed_time = time_ms;
-            ar->pressed      = true;
-            ar->last_time    = time_ms;
-            return true; // disparo inicial
-        } else {
-            // soltou
-            ar->pressed_time = 0;
-            ar->pressed      = false;
-            ar->last_time    = 0;
+    // repetições vencidas até t_us com o estado anterior
+    if(ar->pressed && ar->cfg.arr_us){
+        while(ar->next_us <= t_us){
+            uint32_t step = interval(ar, ar->next_us);
+            if(fired == burst || step == 0){
+                // frame muito atrasado: descarta o resto e segue do agora
+                ar->next_us = t_us + (step ? step : ar->cfg.arr_us);
+                break;
+            }
+            fired++;
+            ar->next_us += step;
         }
     }
-    // se sem auto-repeat
-    if(ar->repeat_time==0) return false;
 
-    // se ainda pressionado
-    if(ar->pressed) {
-        uint32_t repeat_rate= ar->repeat_time;
-        // se passou hold_time, repete mais rápido
-        if(ar->hold_time>0 && (time_ms - ar->pressed_time)> ar->hold_time){
-            repeat_rate/=3;
-        }
-        if((time_ms - ar->last_time)> repeat_rate){
-            ar->last_time= time_ms;
-            return true;
-        }
+    if(pressed && !ar->pressed){
+        // apertou agora: disparo inicial
+        ar->pressed_us = t_us;
+        ar->next_us    = t_us + ar->cfg.das_us;
+        fired++;
     }
-
-    return false;
+    ar->pressed = pressed;
+    return fired;
 }
@@ -8,22 +8,43 @@
 extern "C" {
 #endif
 
+/**
+ * Auto-repeat estilo DAS/ARR com tempos em microssegundos: um disparo ao
+ * apertar, o primeiro repetido das_us depois e então um a cada arr_us
+ * (arr_hold_us depois de hold_us apertado). Cada chamada devolve quantos
+ * disparos venceram até o instante dado, então a velocidade não depende
+ * da taxa de frames e um frame atrasado recupera os disparos perdidos.
+ */
+
+typedef struct {
+    uint32_t das_us;      // aperto -> primeira repetição (> 0)
+    uint32_t arr_us;      // entre repetições; 0 = sem repetição
+    uint32_t hold_us;     // apertado por mais que isto passa a usar arr_hold_us (0 = nunca)
+    uint32_t arr_hold_us;
+    uint8_t  max_burst;   // disparos por chamada no máximo; o excesso é descartado
+} AutoRepeatConfig;
+
 typedef struct {
-    uint32_t repeat_time;
-    uint32_t hold_time;
+    AutoRepeatConfig cfg;
     bool     pressed;
-    bool     last_state;
-    uint32_t pressed_time;
-    uint32_t last_time;
+    uint64_t pressed_us;
+    uint64_t next_us;     // instante da próxima repetição
 } AutoRepeat;
 
-void auto_repeat_init(AutoRepeat *ar,
-                      uint32_t repeat_time,
-                      uint32_t hold_time);
+void auto_repeat_init(AutoRepeat *ar, const AutoRepeatConfig *cfg);
 
-bool auto_repeat_next(AutoRepeat *ar,
-                      uint32_t time_ms,
-                      bool current_state);
+/**
+ * Avança até t_us com o estado 'pressed' a partir de t_us (uma borda ou
+ * o mesmo estado de antes); retorna os disparos vencidos em (última
+ * chamada, t_us]. Os instantes não podem voltar.
+ */
+uint32_t auto_repeat_update(AutoRepeat *ar, uint64_t t_us, bool pressed);
+
+/** Instante do próximo disparo repetido; UINT64_MAX se solto ou sem repetição. */
+static inline uint64_t auto_repeat_next_us(const AutoRepeat *ar)
+{
+    return ar->pressed && ar->cfg.arr_us ? ar->next_us : UINT64_MAX;
+}
 
 #ifdef __cplusplus
 }
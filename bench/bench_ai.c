@@ -0,0 +1,95 @@
+/**
+ * Benchmark da busca do tetris_ai: encaixes avaliados por segundo e
+ * custo de uma decisão em profundidade 1 e 2, comparado ao orçamento de
+ * um frame do laço principal (33 ms).
+ *
+ * Os tabuleiros de teste saem de partidas jogadas pela própria IA, então
+ * têm a altura e os buracos de um jogo real. Compila no host (alvo
+ * bench_ai do build nativo) e no firmware (alvo bench_ai do build Pico,
+ * resultado no USB/stdio).
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include "hal.h"
+#include "tetris_ai.h"
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+#define STATES 64
+#define REPEAT true // repete para quem conectar ao USB depois
+static uint64_t now_us(void) {
+    return hal_time_us();
+}
+#else
+#include <time.h>
+#define STATES 2000
+#define REPEAT false
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+#endif
+
+#define FRAME_BUDGET_US 33000
+
+static TetrisGame states[STATES];
+
+/** Coleta estados de partidas jogadas pela IA (profundidade 1, rápida). */
+static void collect_states(void) {
+    TetrisAiConfig cfg;
+    tetris_ai_default_config(&cfg, 1);
+    TetrisGame g;
+    uint32_t seed = 1;
+    tetris_init(&g, seed, PIECE_RANDOM_BAG);
+    for(int i=0; i<STATES; i++){
+        // alguns lances entre amostras para variar os tabuleiros
+        for(int k=0; k<7 && !g.game_over; k++){
+            TetrisAiMove m = tetris_ai_search(&g, &cfg);
+            tetris_ai_execute(&g, &m);
+        }
+        if(g.game_over) tetris_init(&g, ++seed, PIECE_RANDOM_BAG);
+        states[i] = g;
+    }
+}
+
+static void run_depth(uint8_t depth) {
+    TetrisAiConfig cfg;
+    tetris_ai_default_config(&cfg, depth);
+
+    uint64_t evaluated = 0, worst_us = 0;
+    volatile int32_t sink = 0;
+    uint64_t t0 = now_us();
+    for(int i=0; i<STATES; i++){
+        uint64_t d0 = now_us();
+        TetrisAiMove m = tetris_ai_search(&states[i], &cfg);
+        uint64_t d = now_us() - d0;
+        if(d > worst_us) worst_us = d;
+        evaluated += m.evaluated;
+        sink += m.score;
+    }
+    uint64_t total = now_us() - t0;
+    (void)sink;
+
+    double mean_us = (double)total / STATES;
+    printf("profundidade %u: %9.0f encaixes/s  %6.1f encaixes/decisao  "
+           "decisao media %8.1f us, pior %8llu us (%.1f%% do frame)\n",
+           (unsigned)depth, evaluated * 1e6 / (double)total,
+           (double)evaluated / STATES, mean_us, (unsigned long long)worst_us,
+           100.0 * (double)worst_us / FRAME_BUDGET_US);
+}
+
+int main(void) {
+    hal_init();
+    collect_states();
+    do {
+        if(REPEAT) hal_sleep_ms(2000);
+        printf("bench_ai: %d estados\n", STATES);
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+        printf("clock do sistema: %u MHz\n", (unsigned)(hal_sys_clock_hz() / 1000000u));
+#endif
+        for(uint8_t depth=1; depth<=TETRIS_AI_MAX_DEPTH; depth++){
+            run_depth(depth);
+        }
+    } while(REPEAT);
+    return 0;
+}
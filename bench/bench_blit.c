@@ -0,0 +1,149 @@
+/**
+ * Microbenchmark (host) do desenho de retângulos no framebuffer do
+ * SSD1306: caminho antigo (ssd1306_rect pixel a pixel via
+ * ssd1306_pixel, com a rotação e o recorte refeitos por pixel) contra o
+ * blit por bytes de página de ssd1306.c.
+ *
+ * Antes de medir, confere bit a bit os dois caminhos num tabuleiro cheio
+ * e em retângulos aleatórios (preenchidos ou não, acendendo ou apagando,
+ * inclusive parcialmente fora da tela).
+ *
+ * Alvo bench_blit do build nativo (ver README).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ssd1306.h"
+#include "tetris_board.h"
+
+#define OLED_W      128
+#define OLED_H      64
+#define CELL        6
+#define BOARDS      20000
+#define RANDOM_RECTS 200000
+
+// -------------------------------------------------------------------
+// Implementação antiga, copiada de ssd1306.c como referência
+// -------------------------------------------------------------------
+static void legacy_rect(ssd1306_t *ssd,
+                        uint8_t x, uint8_t y,
+                        uint8_t w, uint8_t h,
+                        bool value, bool fill)
+{
+    if(w==0 || h==0) return;
+    uint8_t x2 = x+w-1;
+    uint8_t y2 = y+h-1;
+
+    for(uint8_t xx=x; xx<=x2; xx++){
+        ssd1306_pixel(ssd, xx, y, value);
+    }
+    for(uint8_t xx=x; xx<=x2; xx++){
+        ssd1306_pixel(ssd, xx, y2, value);
+    }
+    for(uint8_t yy=y; yy<=y2; yy++){
+        ssd1306_pixel(ssd, x, yy, value);
+    }
+    for(uint8_t yy=y; yy<=y2; yy++){
+        ssd1306_pixel(ssd, x2, yy, value);
+    }
+
+    if(fill && w>2 && h>2) {
+        for(uint8_t fill_y=y+1; fill_y<y2; fill_y++){
+            for(uint8_t fill_x=x+1; fill_x<x2; fill_x++){
+                ssd1306_pixel(ssd, fill_x, fill_y, value);
+            }
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+
+typedef void (*rect_fn)(ssd1306_t *ssd, uint8_t x, uint8_t y,
+                        uint8_t w, uint8_t h, bool value, bool fill);
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng = 12345;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/** Tabuleiro inteiro ocupado: 10x20 células 6x6, como tetris_draw. */
+static void draw_full_board(ssd1306_t *ssd, rect_fn rect) {
+    ssd1306_clear(ssd);
+    for(int y=0; y<TETRIS_HEIGHT; y++){
+        for(int x=0; x<TETRIS_WIDTH; x++){
+            rect(ssd, (uint8_t)(x*CELL), (uint8_t)(y*CELL), CELL, CELL, true, true);
+        }
+    }
+}
+
+static bool same_fb(const ssd1306_t *a, const ssd1306_t *b) {
+    return memcmp(a->ram_buffer, b->ram_buffer, a->bufsize) == 0;
+}
+
+int main(void) {
+    static ssd1306_t legacy, blit;
+    ssd1306_init(&legacy, OLED_W, OLED_H, false, 0x3C, 1);
+    ssd1306_init(&blit,   OLED_W, OLED_H, false, 0x3C, 1);
+
+    // Confere tabuleiro cheio
+    draw_full_board(&legacy, legacy_rect);
+    draw_full_board(&blit, ssd1306_rect);
+    if(!same_fb(&legacy, &blit)){
+        printf("MISMATCH no tabuleiro cheio\n");
+        return 1;
+    }
+
+    // Confere retângulos aleatórios sobre um fundo aleatório; coordenadas
+    // até 160 passam da tela lógica (64x128) sem dar a volta nos uint8
+    for(int i=0; i<RANDOM_RECTS; i++){
+        if(i % 64 == 0){
+            for(size_t k=1; k<legacy.bufsize; k++) legacy.ram_buffer[k] = (uint8_t)next_rand();
+            memcpy(blit.ram_buffer, legacy.ram_buffer, legacy.bufsize);
+        }
+        uint8_t x = (uint8_t)(next_rand() % 160), y = (uint8_t)(next_rand() % 160);
+        uint8_t w = (uint8_t)(next_rand() % 48),  h = (uint8_t)(next_rand() % 48);
+        bool value = next_rand() & 1, fill = next_rand() & 1;
+        legacy_rect(&legacy, x, y, w, h, value, fill);
+        ssd1306_rect(&blit, x, y, w, h, value, fill);
+        if(!same_fb(&legacy, &blit)){
+            printf("MISMATCH em rect(%u,%u,%u,%u,value=%d,fill=%d)\n",
+                   x, y, w, h, value, fill);
+            return 1;
+        }
+    }
+    printf("OK: tabuleiro cheio e %d retangulos aleatorios identicos\n", RANDOM_RECTS);
+
+    // Vazão: tabuleiros cheios (200 células) por segundo
+    volatile uint8_t sink = 0;
+    double t0 = now_s();
+    for(int i=0; i<BOARDS; i++){
+        draw_full_board(&legacy, legacy_rect);
+        sink ^= legacy.ram_buffer[1 + i % (legacy.bufsize - 1)];
+    }
+    double t_legacy = now_s() - t0;
+
+    t0 = now_s();
+    for(int i=0; i<BOARDS; i++){
+        draw_full_board(&blit, ssd1306_rect);
+        sink ^= blit.ram_buffer[1 + i % (blit.bufsize - 1)];
+    }
+    double t_blit = now_s() - t0;
+    (void)sink;
+
+    printf("tabuleiro cheio (%d celulas %dx%d):\n", TETRIS_WIDTH * TETRIS_HEIGHT, CELL, CELL);
+    printf("  pixel a pixel: %8.0f tabuleiros/s (%6.2f us cada)\n",
+           BOARDS / t_legacy, t_legacy / BOARDS * 1e6);
+    printf("  blit:          %8.0f tabuleiros/s (%6.2f us cada)  %.1fx\n",
+           BOARDS / t_blit, t_blit / BOARDS * 1e6, t_legacy / t_blit);
+    return 0;
+}
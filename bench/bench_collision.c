@@ -0,0 +1,150 @@
+/**
+ * Microbenchmark (host) de check_collision: implementação antiga
+ * (int board[W][H], forma de 16 bits varrida bit a bit) contra o
+ * tabuleiro em bitboard de tetris_board.c.
+ *
+ * Alvo bench_collision do build nativo (ver README).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "tetris_board.h"
+
+#define NUM_BOARDS   64
+#define NUM_QUERIES  4096
+#define ROUNDS       400
+
+// -------------------------------------------------------------------
+// Implementação antiga, copiada de tetris.c como referência
+// -------------------------------------------------------------------
+static const unsigned int LEGACY_SHAPES[TETRIS_NUM_PIECES][4] = {
+    {0x0F00,0x2222,0x00F0,0x4444},
+    {0xCC00,0xCC00,0xCC00,0xCC00},
+    {0x0E40,0x4C40,0x4E00,0x4640},
+    {0x06C0,0x8C40,0x6C00,0x4620},
+    {0x0C60,0x4C80,0xC600,0x2640},
+    {0x44C0,0x8E00,0x6440,0x0E20},
+    {0x4460,0x0E80,0xC440,0x2E00},
+};
+
+typedef struct {
+    int cells[TETRIS_WIDTH][TETRIS_HEIGHT];
+} LegacyBoard;
+
+static bool legacy_collision(const LegacyBoard *lb, int type, int nrot, int nx, int ny) {
+    unsigned int blocks = LEGACY_SHAPES[type][nrot];
+    unsigned int bit = 0x8000;
+    int row=0, col=0;
+
+    for(; bit>0; bit>>=1) {
+        if(blocks & bit) {
+            int bx = nx + col;
+            int by = ny + row;
+            if(bx<0 || bx>=TETRIS_WIDTH || by<0|| by>=TETRIS_HEIGHT) {
+                return true;
+            }
+            if(lb->cells[bx][by] != 0) {
+                return true;
+            }
+        }
+        col++;
+        if(col==4) { col=0; row++; }
+    }
+    return false;
+}
+
+// -------------------------------------------------------------------
+
+typedef struct {
+    int type, rot, x, y;
+} Query;
+
+static LegacyBoard legacy[NUM_BOARDS];
+static TetrisBoard boards[NUM_BOARDS];
+static Query queries[NUM_QUERIES];
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Pilha aleatória: linhas de baixo mais cheias que as de cima
+static void random_boards(void) {
+    for(int i=0; i<NUM_BOARDS; i++){
+        tetris_board_clear(&boards[i]);
+        int top = 4 + rand() % (TETRIS_HEIGHT - 4);
+        for(int y=0; y<TETRIS_HEIGHT; y++){
+            for(int x=0; x<TETRIS_WIDTH; x++){
+                int filled = (y >= top) && (rand() % 10 < 7);
+                legacy[i].cells[x][y] = filled ? 1 : 0;
+                if(filled) boards[i].rows[y] |= TETRIS_CELL_BIT(x);
+            }
+        }
+    }
+}
+
+static void random_queries(void) {
+    for(int i=0; i<NUM_QUERIES; i++){
+        queries[i].type = rand() % TETRIS_NUM_PIECES;
+        queries[i].rot  = rand() % 4;
+        queries[i].x    = -4 + rand() % (TETRIS_WIDTH + 5);
+        queries[i].y    = -2 + rand() % (TETRIS_HEIGHT + 3);
+    }
+}
+
+int main(void) {
+    srand(1234);
+    random_boards();
+    random_queries();
+
+    // Confere que as duas implementações concordam
+    long hits = 0;
+    for(int b=0; b<NUM_BOARDS; b++){
+        for(int q=0; q<NUM_QUERIES; q++){
+            const Query *qq = &queries[q];
+            bool a = legacy_collision(&legacy[b], qq->type, qq->rot, qq->x, qq->y);
+            bool n = tetris_board_collides(&boards[b], qq->type, qq->rot, qq->x, qq->y);
+            if(a != n){
+                printf("MISMATCH board=%d type=%d rot=%d x=%d y=%d legacy=%d bitboard=%d\n",
+                       b, qq->type, qq->rot, qq->x, qq->y, a, n);
+                return 1;
+            }
+            hits += a;
+        }
+    }
+
+    const double total = (double)ROUNDS * NUM_BOARDS * NUM_QUERIES;
+    volatile long sink = 0;
+
+    double t0 = now_s();
+    for(int r=0; r<ROUNDS; r++){
+        for(int b=0; b<NUM_BOARDS; b++){
+            for(int q=0; q<NUM_QUERIES; q++){
+                const Query *qq = &queries[q];
+                sink += legacy_collision(&legacy[b], qq->type, qq->rot, qq->x, qq->y);
+            }
+        }
+    }
+    double t_legacy = now_s() - t0;
+
+    t0 = now_s();
+    for(int r=0; r<ROUNDS; r++){
+        for(int b=0; b<NUM_BOARDS; b++){
+            for(int q=0; q<NUM_QUERIES; q++){
+                const Query *qq = &queries[q];
+                sink += tetris_board_collides(&boards[b], qq->type, qq->rot, qq->x, qq->y);
+            }
+        }
+    }
+    double t_bitboard = now_s() - t0;
+
+    printf("colisoes verificadas: %.0f (%.1f%% positivas)\n",
+           total, 100.0 * hits / ((double)NUM_BOARDS * NUM_QUERIES));
+    printf("legacy   : %8.2f Mcol/s\n", total / t_legacy / 1e6);
+    printf("bitboard : %8.2f Mcol/s\n", total / t_bitboard / 1e6);
+    printf("speedup  : %8.2fx\n", t_legacy / t_bitboard);
+    printf("RAM tabuleiro: legacy %zu bytes, bitboard %zu bytes\n",
+           sizeof(LegacyBoard), sizeof(TetrisBoard));
+    return 0;
+}
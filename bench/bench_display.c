@@ -0,0 +1,138 @@
+/**
+ * Benchmark (host) do caminho até o painel: tetris_render + ssd1306_show
+ * com o emulador de ssd1306_emu.h no lugar do SSD1306.
+ *
+ * A cada frame confere que a GRAM do emulador ficou igual ao framebuffer
+ * (o envio só das janelas alteradas não pode perder nada) e que o painel
+ * terminou a configuração no estado esperado. Depois compara o custo de
+ * barramento do envio por janelas com o da tela inteira: transações,
+ * bytes e tempo estimado a 400 kHz.
+ *
+ *   bench_display [diretorio]   grava frame_NNNNN.pbm a cada PBM_EVERY frames
+ *
+ * Alvo bench_display do build nativo (ver README).
+ */
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "ssd1306_emu.h"
+#include "tetris.h"
+#include "tetris_render.h"
+
+#define OLED_W    128
+#define OLED_H    64
+#define OLED_ADDR 0x3C
+#define FRAMES    5000
+#define STEP_MS   33
+#define PBM_EVERY 500
+#define I2C_HZ    400000
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+typedef struct {
+    uint64_t transactions, bytes, data_bytes;
+    uint32_t max_bytes;
+} BusTotals;
+
+static void add(BusTotals *t, const SSD1306EmuCounters *c) {
+    t->transactions += c->transactions;
+    t->bytes        += c->bytes;
+    t->data_bytes   += c->data_bytes;
+    if(c->bytes > t->max_bytes) t->max_bytes = c->bytes;
+}
+
+// Cada byte custa 9 bits no barramento; cada transação, endereço + start/stop (~10 bits)
+static double bus_us(double bytes, double transactions) {
+    return (bytes * 9 + transactions * 10) * 1e6 / I2C_HZ;
+}
+
+static void print_totals(const char *label, const BusTotals *t) {
+    double n = FRAMES;
+    printf("%-16s %6.1f transacoes/frame %8.1f bytes/frame (dados %7.1f, max %u)  ~%7.0f us/frame a 400 kHz\n",
+           label, t->transactions / n, t->bytes / n, t->data_bytes / n, (unsigned)t->max_bytes,
+           bus_us(t->bytes / n, t->transactions / n));
+}
+
+/** Roda FRAMES frames; full = reenvia a tela inteira em cada um. */
+static int run(bool full, const char *dir, BusTotals *out) {
+    static SSD1306Emu emu;
+    static ssd1306_t oled;
+    ssd1306_emu_init(&emu, OLED_ADDR);
+    ssd1306_emu_attach(&emu);
+    ssd1306_init(&oled, OLED_W, OLED_H, false, OLED_ADDR, 1);
+    ssd1306_config(&oled);
+    SSD1306EmuCounters cfg = ssd1306_emu_end_frame(&emu);
+    if(!full) printf("configuracao: %u transacoes, %u bytes\n",
+                     (unsigned)cfg.transactions, (unsigned)cfg.bytes);
+
+    if(!emu.display_on || emu.mode != 0 || emu.seg_remap || !emu.com_remap ||
+       emu.mux != OLED_H || emu.unknown_commands){
+        printf("configuracao inesperada no painel\n");
+        return 1;
+    }
+
+    TetrisRenderer r;
+    tetris_renderer_init(&r);
+    TetrisGame g;
+    uint32_t seed = 1;
+    tetris_init(&g, seed, PIECE_RANDOM_BAG);
+    rng = 2463534242u;
+    memset(out, 0, sizeof(*out));
+
+    for(int i=0; i<FRAMES; i++){
+        tetris_update(&g, STEP_MS);
+        uint8_t actions = 0;
+        if((next_rand() & 3) == 0) actions = (uint8_t)(1u << (next_rand() % 7));
+        tetris_apply_actions(&g, actions);
+        tetris_take_events(&g);
+
+        TetrisSnapshot s;
+        tetris_snapshot(&g, &s);
+        tetris_render(&r, &s, &oled);
+        if(full) ssd1306_invalidate(&oled);
+        ssd1306_show(&oled);
+
+        SSD1306EmuCounters c = ssd1306_emu_end_frame(&emu);
+        add(out, &c);
+        if(c.transactions != oled.frame_transactions || c.bytes != oled.frame_bytes){
+            printf("contadores do driver (%u transacoes, %u bytes) diferentes do painel (%u, %u) no frame %d\n",
+                   (unsigned)oled.frame_transactions, (unsigned)oled.frame_bytes,
+                   (unsigned)c.transactions, (unsigned)c.bytes, i);
+            return 1;
+        }
+        if(memcmp(emu.gram, oled.ram_buffer + 1, sizeof(emu.gram)) != 0){
+            printf("GRAM diferente do framebuffer no frame %d\n", i);
+            return 1;
+        }
+        if(dir && i % PBM_EVERY == 0){
+            char path[512];
+            snprintf(path, sizeof(path), "%s/frame_%05d.pbm", dir, i);
+            if(!ssd1306_emu_write_pbm(&emu, path)){
+                perror(path);
+                return 1;
+            }
+        }
+        if(tetris_is_game_over(&g)) tetris_init(&g, ++seed, PIECE_RANDOM_BAG);
+    }
+    ssd1306_emu_attach(NULL);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *dir = argc > 1 ? argv[1] : NULL;
+    BusTotals diff, full;
+    if(run(false, dir, &diff)) return 1;
+    if(run(true, NULL, &full)) return 1;
+
+    printf("OK: %d frames, GRAM do emulador igual ao framebuffer em todos\n", FRAMES);
+    print_totals("janelas alteradas", &diff);
+    print_totals("tela inteira", &full);
+    printf("bytes no barramento: %.1fx menos\n", (double)full.bytes / diff.bytes);
+    return 0;
+}
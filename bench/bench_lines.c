@@ -0,0 +1,175 @@
+/**
+ * Microbenchmark (host) de lock_piece + remove_lines com pilhas próximas
+ * do topo: implementação antiga (varre as 20 linhas e desce o tabuleiro
+ * célula a célula a cada linha completa) contra a remoção incremental de
+ * tetris_board.c.
+ *
+ * Alvo bench_lines do build nativo (ver README).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tetris_board.h"
+
+#define ITERATIONS 2000000
+
+// -------------------------------------------------------------------
+// Implementação antiga, copiada de tetris.c como referência
+// -------------------------------------------------------------------
+static const unsigned int LEGACY_SHAPES[TETRIS_NUM_PIECES][4] = {
+    {0x0F00,0x2222,0x00F0,0x4444},
+    {0xCC00,0xCC00,0xCC00,0xCC00},
+    {0x0E40,0x4C40,0x4E00,0x4640},
+    {0x06C0,0x8C40,0x6C00,0x4620},
+    {0x0C60,0x4C80,0xC600,0x2640},
+    {0x44C0,0x8E00,0x6440,0x0E20},
+    {0x4460,0x0E80,0xC440,0x2E00},
+};
+
+typedef struct {
+    int cells[TETRIS_WIDTH][TETRIS_HEIGHT];
+} LegacyBoard;
+
+static void legacy_lock(LegacyBoard *lb, int type, int rot, int x, int y, int color) {
+    unsigned int blocks = LEGACY_SHAPES[type][rot];
+    unsigned int bit=0x8000;
+    int row=0,col=0;
+    for(; bit>0; bit>>=1) {
+        if(blocks & bit) {
+            lb->cells[x + col][y + row] = color;
+        }
+        col++;
+        if(col==4){ col=0; row++; }
+    }
+}
+
+static int legacy_remove_lines(LegacyBoard *lb) {
+    int lines_cleared=0;
+    for(int y=0; y<TETRIS_HEIGHT; y++){
+        bool full=true;
+        for(int x=0; x< TETRIS_WIDTH;x++){
+            if(lb->cells[x][y]==0){
+                full=false;
+                break;
+            }
+        }
+        if(full){
+            lines_cleared++;
+            for(int yy=y; yy>0;yy--){
+                for(int xx=0;xx<TETRIS_WIDTH;xx++){
+                    lb->cells[xx][yy]= lb->cells[xx][yy-1];
+                }
+            }
+            for(int xx=0;xx<TETRIS_WIDTH;xx++){
+                lb->cells[xx][0]=0;
+            }
+        }
+    }
+    return lines_cleared;
+}
+
+// -------------------------------------------------------------------
+
+typedef struct {
+    const char *name;
+    int type, rot, x, y;  // peça travada
+    int expected_lines;
+} Scenario;
+
+/**
+ * Pilha de 'height' linhas cheias, exceto a coluna 'hole' (poço).
+ * As linhas acima da pilha ficam vazias.
+ */
+static void build_stack(LegacyBoard *lb, TetrisBoard *b, int height, int hole) {
+    memset(lb, 0, sizeof(*lb));
+    tetris_board_clear(b);
+    for(int y=TETRIS_HEIGHT-height; y<TETRIS_HEIGHT; y++){
+        for(int x=0; x<TETRIS_WIDTH; x++){
+            if(x == hole) continue;
+            lb->cells[x][y] = 1 + (x % 7);
+        }
+        b->rows[y] = (uint16_t)(TETRIS_ROW_FULL & ~TETRIS_CELL_BIT(hole));
+        for(int x=0; x<TETRIS_WIDTH; x+=2){
+            b->colors[y][x >> 1] = (uint8_t)((1 + (x % 7)) | ((1 + ((x + 1) % 7)) << 4));
+        }
+        b->colors[y][hole >> 1] &= (uint8_t)~(0x0F << ((hole & 1) * 4));
+    }
+    b->top = (int8_t)(TETRIS_HEIGHT - height);
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool same_board(const LegacyBoard *lb, const TetrisBoard *b) {
+    for(int y=0; y<TETRIS_HEIGHT; y++){
+        for(int x=0; x<TETRIS_WIDTH; x++){
+            if((uint8_t)lb->cells[x][y] != tetris_board_color(b, x, y)) return false;
+            if(((b->rows[y] & TETRIS_CELL_BIT(x)) != 0) != (lb->cells[x][y] != 0)) return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    // Pilha de 18 linhas com poço na coluna 9: o I vertical completa
+    // 4 linhas, o O no topo não completa nenhuma.
+    const int height = 18, hole = 9;
+    const Scenario scenarios[] = {
+        { "tetris (4 linhas)", 0, 1, hole - 2, TETRIS_HEIGHT - 4, 4 },
+        { "sem linhas, topo",  1, 0, 0,        TETRIS_HEIGHT - height - 2, 0 },
+    };
+
+    static LegacyBoard lb_tpl, lb;
+    static TetrisBoard b_tpl, b;
+    build_stack(&lb_tpl, &b_tpl, height, hole);
+
+    volatile long sink = 0;
+    for(size_t s=0; s<sizeof(scenarios)/sizeof(scenarios[0]); s++){
+        const Scenario *sc = &scenarios[s];
+
+        // Confere resultado
+        lb = lb_tpl; b = b_tpl;
+        legacy_lock(&lb, sc->type, sc->rot, sc->x, sc->y, sc->type + 1);
+        int nl = legacy_remove_lines(&lb);
+        TetrisRowSpan span = tetris_board_lock(&b, sc->type, sc->rot, sc->x, sc->y, (uint8_t)(sc->type + 1));
+        int nb = __builtin_popcount(tetris_board_remove_lines(&b, span));
+        if(nl != sc->expected_lines || nb != nl || !same_board(&lb, &b)){
+            printf("MISMATCH em '%s': legacy=%d bitboard=%d\n", sc->name, nl, nb);
+            return 1;
+        }
+
+        // Custo da cópia do tabuleiro, descontado das medidas abaixo
+        double t0 = now_s();
+        for(int i=0; i<ITERATIONS; i++){ lb = lb_tpl; sink += lb.cells[0][TETRIS_HEIGHT-1]; }
+        double t_copy_legacy = now_s() - t0;
+        t0 = now_s();
+        for(int i=0; i<ITERATIONS; i++){ b = b_tpl; sink += b.rows[TETRIS_HEIGHT-1]; }
+        double t_copy_bitboard = now_s() - t0;
+
+        t0 = now_s();
+        for(int i=0; i<ITERATIONS; i++){
+            lb = lb_tpl;
+            legacy_lock(&lb, sc->type, sc->rot, sc->x, sc->y, sc->type + 1);
+            sink += legacy_remove_lines(&lb);
+        }
+        double t_legacy = now_s() - t0 - t_copy_legacy;
+
+        t0 = now_s();
+        for(int i=0; i<ITERATIONS; i++){
+            b = b_tpl;
+            span = tetris_board_lock(&b, sc->type, sc->rot, sc->x, sc->y, (uint8_t)(sc->type + 1));
+            sink += __builtin_popcount(tetris_board_remove_lines(&b, span));
+        }
+        double t_bitboard = now_s() - t0 - t_copy_bitboard;
+
+        printf("%-20s pilha=%d  legacy %7.1f ns/lock   bitboard %7.1f ns/lock   (%.1fx)\n",
+               sc->name, height,
+               t_legacy * 1e9 / ITERATIONS, t_bitboard * 1e9 / ITERATIONS,
+               t_legacy / t_bitboard);
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * Microbenchmark (host) do desenho de um frame: tetris_draw_snapshot
+ * (limpa o framebuffer e redesenha todas as células) contra o
+ * renderizador por tiles de tetris_render.c (só as células que mudaram).
+ *
+ * Roda partidas com entradas aleatórias, com as animações visuais do
+ * firmware (linhas piscando com a peça escondida, banner do game over),
+ * e, frame a frame, confere que os dois framebuffers são idênticos byte
+ * a byte. Depois mede o custo por
+ * frame de cada caminho sobre a mesma sequência de snapshots.
+ *
+ * Alvo bench_render do build nativo (ver README).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ssd1306.h"
+#include "tetris.h"
+#include "tetris_render.h"
+#include "anim.h"
+#include "tetris_ai.h"
+
+#define OLED_W  128
+#define OLED_H  64
+#define FRAMES  20000
+#define STEP_MS 33
+
+// Trilhas visuais de Projeto_Tetris.c
+static const AnimTrack ROWS_ANIM   = { .target = ANIM_ROWS, .count = 2, .on_us = 50000, .off_us = 50000 };
+static const AnimTrack BANNER_ANIM = { .target = ANIM_BANNER, .count = 1, .on_us = 2000000 };
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+int main(void) {
+    // Sequência de snapshots de partidas com entradas aleatórias
+    static TetrisSnapshot snaps[FRAMES];
+    TetrisGame g;
+    Anim anim;
+    TetrisAi ai;
+    TetrisAiConfig ai_cfg;
+    uint32_t seed = 1, hidden = 0, banner = 0;
+    tetris_init(&g, seed, PIECE_RANDOM_BAG);
+    anim_init(&anim);
+    tetris_ai_default_config(&ai_cfg, 1);
+    tetris_ai_init(&ai, &ai_cfg);
+    for(int i=0; i<FRAMES; i++){
+        uint64_t t_us = (uint64_t)i * STEP_MS * 1000;
+        tetris_update(&g, STEP_MS);
+        // blocos de 8 peças da IA (linhas completas) e 8 aleatórias (game over)
+        if((g.pieces / 8) % 2 == 0){
+            tetris_ai_step(&ai, &g);
+        } else {
+            uint8_t actions = 0;
+            if((next_rand() & 3) == 0) actions = (uint8_t)(1u << (next_rand() % 7));
+            tetris_apply_actions(&g, actions);
+        }
+        uint8_t events = tetris_take_events(&g);
+        if(events & TETRIS_EVENT_LOCK) anim_cancel(&anim, ANIM_ROWS);
+        if((events & TETRIS_EVENT_LINES) && g.cleared_rows){
+            AnimTrack rows = ROWS_ANIM;
+            rows.arg = g.cleared_rows;
+            anim_start(&anim, &rows, 1, t_us);
+        }
+        if(events & TETRIS_EVENT_GAME_OVER) anim_start(&anim, &BANNER_ANIM, 1, t_us);
+        anim_update(&anim, t_us);
+
+        tetris_snapshot(&g, &snaps[i]);
+        anim_apply(&anim, &snaps[i]);
+        hidden += snaps[i].piece_hidden;
+        banner += snaps[i].banner;
+        if(tetris_is_game_over(&g) && !anim_running(&anim)){
+            tetris_init(&g, ++seed, PIECE_RANDOM_BAG);
+            tetris_ai_init(&ai, &ai_cfg);
+        }
+    }
+    if(!hidden || !banner){
+        printf("sequencia sem linhas piscando (%u) ou sem banner (%u)\n", (unsigned)hidden, (unsigned)banner);
+        return 1;
+    }
+
+    static ssd1306_t full, tiles;
+    ssd1306_init(&full,  OLED_W, OLED_H, false, 0x3C, 1);
+    ssd1306_init(&tiles, OLED_W, OLED_H, false, 0x3C, 1);
+    TetrisRenderer r;
+    tetris_renderer_init(&r);
+
+    // Confere frame a frame
+    uint64_t cells = 0;
+    for(int i=0; i<FRAMES; i++){
+        tetris_draw_snapshot(&snaps[i], &full);
+        cells += tetris_render(&r, &snaps[i], &tiles);
+        if(memcmp(full.ram_buffer, tiles.ram_buffer, full.bufsize) != 0){
+            printf("MISMATCH no frame %d\n", i);
+            return 1;
+        }
+    }
+    printf("OK: %d frames identicos (%u partidas, %u com linhas piscando, %u com banner), "
+           "%.2f celulas reescritas/frame\n",
+           FRAMES, (unsigned)seed, (unsigned)hidden, (unsigned)banner, (double)cells / FRAMES);
+
+    volatile uint8_t sink = 0;
+    double t0 = now_s();
+    for(int i=0; i<FRAMES; i++){
+        tetris_draw_snapshot(&snaps[i], &full);
+        sink ^= full.ram_buffer[1 + i % (full.bufsize - 1)];
+    }
+    double t_full = now_s() - t0;
+
+    tetris_renderer_init(&r);
+    t0 = now_s();
+    for(int i=0; i<FRAMES; i++){
+        tetris_render(&r, &snaps[i], &tiles);
+        sink ^= tiles.ram_buffer[1 + i % (tiles.bufsize - 1)];
+    }
+    double t_tiles = now_s() - t0;
+    (void)sink;
+
+    printf("redesenho completo: %7.3f us/frame\n", t_full / FRAMES * 1e6);
+    printf("tiles alterados:    %7.3f us/frame  %.1fx\n",
+           t_tiles / FRAMES * 1e6, t_full / t_tiles);
+    return 0;
+}
@@ -0,0 +1,447 @@
+/**
+ * Suíte de microbenchmarks (host) dos caminhos quentes do motor e do
+ * driver, para comparar uma mudança contra a anterior:
+ *
+ *   board_collides      tetris_board_collides em pilhas e consultas aleatórias
+ *   lock_remove_lines   cópia do tabuleiro + tetris_board_lock + tetris_board_remove_lines
+ *   hard_drop           cópia da partida + tetris_hard_drop
+ *   tetris_draw         tetris_draw completo no framebuffer
+ *   draw_string         ssd1306_draw_string
+ *   ssd1306_show        cópia de um frame + ssd1306_show (só janelas alteradas)
+ *   ssd1306_show_full   idem, reenviando a tela inteira
+ *   board_copy / game_copy   as cópias acima sozinhas, para descontar
+ *
+ * Cada caso é calibrado até uma amostra durar MIN_SAMPLE_S e então
+ * medido em N amostras: min, mediana, média e desvio padrão em ns/op.
+ * Os casos do display também reportam bytes e transações I2C por op
+ * (contadores do hal_host). As entradas saem de sementes fixas, então
+ * duas execuções medem exatamente o mesmo trabalho.
+ *
+ *   bench_suite [-n amostras] [-j arquivo.json] [filtro]
+ *
+ * Com -j grava também o resultado em JSON ("-" = só JSON no stdout);
+ * o filtro roda só os casos cujo nome contém o texto.
+ *
+ * Alvo bench_suite do build nativo (ver README).
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "hal_host.h"
+#include "ssd1306.h"
+#include "tetris.h"
+#include "tetris_render.h"
+
+#define OLED_W    128
+#define OLED_H    64
+#define OLED_ADDR 0x3C
+
+#define DEFAULT_SAMPLES 15
+#define MAX_SAMPLES     101
+#define MIN_SAMPLE_S    0.02
+
+// Tamanhos dos conjuntos de entrada (potências de 2: índice por máscara)
+#define NUM_BOARDS  64
+#define NUM_QUERIES 4096
+#define NUM_STACKS  256
+#define NUM_GAMES   64
+#define NUM_STRINGS 8
+#define NUM_FRAMES  256
+
+typedef struct {
+    int8_t type, rot, x, y;
+} Query;
+
+typedef struct {
+    const char *name;
+    void (*run)(uint64_t ops);
+} BenchCase;
+
+typedef struct {
+    uint64_t ops;                       // por amostra
+    double   min, median, mean, stddev; // ns/op
+    double   i2c_bytes, i2c_transactions; // por op
+} BenchResult;
+
+static TetrisBoard boards[NUM_BOARDS];
+static Query       queries[NUM_QUERIES];
+static TetrisBoard stacks[NUM_STACKS];
+static Query       drops[NUM_STACKS];
+static TetrisGame  games[NUM_GAMES];
+static uint8_t     frames[NUM_FRAMES][OLED_W * OLED_H / 8];
+static ssd1306_t   oled;
+
+static const char *const strings[NUM_STRINGS] = {
+    "SCORE", "0", "1234567", "GAME OVER", "NEXT", "LINES 42", "A", "TETRIS!",
+};
+
+static volatile uint32_t sink;
+
+// Impede o compilador de reduzir a cópia ao único campo lido depois
+#define ESCAPE(p) __asm__ volatile("" : : "r"(p) : "memory")
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -------------------------------------------------------------------
+// Entradas
+// -------------------------------------------------------------------
+
+/** Acerta top e heights depois de escrever rows à mão. */
+static void fix_board(TetrisBoard *b) {
+    b->top = TETRIS_HEIGHT;
+    for(int y=TETRIS_HEIGHT-1; y>=0; y--){
+        if(b->rows[y] != TETRIS_ROW_EMPTY) b->top = (int8_t)y;
+    }
+    for(int x=0; x<TETRIS_WIDTH; x++){
+        b->heights[x] = 0;
+        for(int y=0; y<TETRIS_HEIGHT; y++){
+            if(b->rows[y] & TETRIS_CELL_BIT(x)){
+                b->heights[x] = (int8_t)(TETRIS_HEIGHT - y);
+                break;
+            }
+        }
+    }
+}
+
+/** Pilha com blocos (com cor) nas linhas de baixo, densidade ~70%, como em bench_collision. */
+static void random_board(TetrisBoard *b) {
+    tetris_board_clear(b);
+    int top = 4 + (int)(next_rand() % (TETRIS_HEIGHT - 4));
+    for(int y=top; y<TETRIS_HEIGHT; y++){
+        for(int x=0; x<TETRIS_WIDTH; x++){
+            if(next_rand() % 10 < 7){
+                b->rows[y] |= TETRIS_CELL_BIT(x);
+                b->colors[y][x >> 1] |= (uint8_t)((1 + x % 7) << ((x & 1) * 4));
+            }
+        }
+    }
+    fix_board(b);
+}
+
+/**
+ * Pilha de 2..15 linhas com um buraco por linha; metade das vezes o
+ * buraco repete o da linha de baixo, formando poços. Em 1/4 das pilhas a
+ * peça é um I vertical no poço de baixo, que remove linhas; nas outras é
+ * uma peça qualquer largada de cima numa coluna qualquer.
+ */
+static void random_stack(TetrisBoard *b, Query *q) {
+    tetris_board_clear(b);
+    int height = 2 + (int)(next_rand() % 14);
+    int hole = (int)(next_rand() % TETRIS_WIDTH);
+    for(int y=TETRIS_HEIGHT-1; y>=TETRIS_HEIGHT-height; y--){
+        if(next_rand() & 1) hole = (int)(next_rand() % TETRIS_WIDTH);
+        for(int x=0; x<TETRIS_WIDTH; x++){
+            if(x == hole) continue;
+            b->rows[y] |= TETRIS_CELL_BIT(x);
+            b->colors[y][x >> 1] |= (uint8_t)((1 + x % 7) << ((x & 1) * 4));
+        }
+    }
+    fix_board(b);
+
+    if((next_rand() & 3) == 0){
+        // I vertical ocupa a coluna 2 da peça na rotação 1
+        int well = (int)(next_rand() % TETRIS_WIDTH);
+        for(int x=0; x<TETRIS_WIDTH; x++){
+            if(b->heights[x] < b->heights[well]) well = x;
+        }
+        q->type = 0;
+        q->rot  = 1;
+        q->x    = (int8_t)(well - 2);
+    } else {
+        do {
+            q->type = (int8_t)(next_rand() % TETRIS_NUM_PIECES);
+            q->rot  = (int8_t)(next_rand() % 4);
+            q->x    = (int8_t)(-2 + (int)(next_rand() % (TETRIS_WIDTH + 2)));
+        } while(tetris_board_collides(b, q->type, q->rot, q->x, 0));
+    }
+    q->y = (int8_t)tetris_board_drop_y(b, q->type, q->rot, q->x, 0);
+}
+
+/** Partida da semente 'seed' jogada ao acaso por algumas peças. */
+static void random_game(TetrisGame *g, uint32_t seed) {
+    tetris_init(g, seed, PIECE_RANDOM_BAG);
+    uint32_t pieces = next_rand() % 24;
+    while(g->pieces < pieces && !tetris_is_game_over(g)){
+        uint8_t actions = (uint8_t)(next_rand() & (TETRIS_ACTION_ROT_CCW | TETRIS_ACTION_ROT_CW |
+                                                   TETRIS_ACTION_LEFT | TETRIS_ACTION_RIGHT));
+        tetris_apply_actions(g, actions);
+        if((next_rand() & 3) == 0) tetris_hard_drop(g);
+        else tetris_update(g, 100);
+    }
+    if(tetris_is_game_over(g)) tetris_init(g, seed, PIECE_RANDOM_BAG);
+    tetris_take_events(g);
+}
+
+/** Frames consecutivos de uma partida com entradas aleatórias, pelo renderer do jogo. */
+static void record_frames(void) {
+    static TetrisRenderer r;
+    TetrisGame g;
+    TetrisSnapshot s;
+    tetris_renderer_init(&r);
+    tetris_init(&g, 1, PIECE_RANDOM_BAG);
+    for(int i=0; i<NUM_FRAMES; i++){
+        tetris_update(&g, 33);
+        if((next_rand() & 3) == 0) tetris_apply_actions(&g, (uint8_t)(1u << (next_rand() % 7)));
+        if(tetris_is_game_over(&g)) tetris_init(&g, (uint32_t)i, PIECE_RANDOM_BAG);
+        tetris_snapshot(&g, &s);
+        tetris_render(&r, &s, &oled);
+        memcpy(frames[i], oled.ram_buffer + 1, sizeof(frames[i]));
+    }
+}
+
+static void setup(void) {
+    rng = 2463534242u;
+    for(int i=0; i<NUM_BOARDS; i++) random_board(&boards[i]);
+    for(int i=0; i<NUM_QUERIES; i++){
+        queries[i].type = (int8_t)(next_rand() % TETRIS_NUM_PIECES);
+        queries[i].rot  = (int8_t)(next_rand() % 4);
+        queries[i].x    = (int8_t)(-4 + (int)(next_rand() % (TETRIS_WIDTH + 5)));
+        queries[i].y    = (int8_t)(-2 + (int)(next_rand() % (TETRIS_HEIGHT + 3)));
+    }
+    for(int i=0; i<NUM_STACKS; i++) random_stack(&stacks[i], &drops[i]);
+    for(int i=0; i<NUM_GAMES; i++) random_game(&games[i], 1000u + (uint32_t)i);
+
+    ssd1306_init(&oled, OLED_W, OLED_H, false, OLED_ADDR, 1);
+    record_frames();
+}
+
+// -------------------------------------------------------------------
+// Casos
+// -------------------------------------------------------------------
+
+static void run_board_collides(uint64_t ops) {
+    uint32_t hits = 0;
+    for(uint64_t i=0; i<ops; i++){
+        const TetrisBoard *b = &boards[(i / NUM_QUERIES) & (NUM_BOARDS - 1)];
+        const Query *q = &queries[i & (NUM_QUERIES - 1)];
+        hits += tetris_board_collides(b, q->type, q->rot, q->x, q->y);
+    }
+    sink += hits;
+}
+
+static void run_board_copy(uint64_t ops) {
+    TetrisBoard b;
+    for(uint64_t i=0; i<ops; i++){
+        b = stacks[i & (NUM_STACKS - 1)];
+        ESCAPE(&b);
+    }
+}
+
+static void run_lock_remove_lines(uint64_t ops) {
+    TetrisBoard b;
+    uint32_t lines = 0;
+    for(uint64_t i=0; i<ops; i++){
+        const Query *q = &drops[i & (NUM_STACKS - 1)];
+        b = stacks[i & (NUM_STACKS - 1)];
+        TetrisRowSpan span = tetris_board_lock(&b, q->type, q->rot, q->x, q->y, (uint8_t)(q->type + 1));
+        lines += (uint32_t)__builtin_popcount(tetris_board_remove_lines(&b, span));
+    }
+    sink += lines;
+}
+
+static void run_game_copy(uint64_t ops) {
+    TetrisGame g;
+    for(uint64_t i=0; i<ops; i++){
+        g = games[i & (NUM_GAMES - 1)];
+        ESCAPE(&g);
+    }
+}
+
+static void run_hard_drop(uint64_t ops) {
+    TetrisGame g;
+    for(uint64_t i=0; i<ops; i++){
+        g = games[i & (NUM_GAMES - 1)];
+        tetris_hard_drop(&g);
+        sink += g.score;
+    }
+}
+
+static void run_tetris_draw(uint64_t ops) {
+    for(uint64_t i=0; i<ops; i++){
+        tetris_draw(&games[i & (NUM_GAMES - 1)], &oled);
+    }
+    sink += oled.ram_buffer[1];
+}
+
+static void run_draw_string(uint64_t ops) {
+    for(uint64_t i=0; i<ops; i++){
+        uint8_t x = (uint8_t)((i * 7) & 63);
+        uint8_t y = (uint8_t)((i * 5) & 63);
+        ssd1306_draw_string(&oled, strings[i & (NUM_STRINGS - 1)], x, y);
+    }
+    sink += oled.ram_buffer[1];
+}
+
+static void run_show(uint64_t ops) {
+    for(uint64_t i=0; i<ops; i++){
+        memcpy(oled.ram_buffer + 1, frames[i & (NUM_FRAMES - 1)], sizeof(frames[0]));
+        ssd1306_show(&oled);
+    }
+}
+
+static void run_show_full(uint64_t ops) {
+    for(uint64_t i=0; i<ops; i++){
+        memcpy(oled.ram_buffer + 1, frames[i & (NUM_FRAMES - 1)], sizeof(frames[0]));
+        ssd1306_invalidate(&oled);
+        ssd1306_show(&oled);
+    }
+}
+
+static const BenchCase cases[] = {
+    { "board_collides",    run_board_collides },
+    { "board_copy",        run_board_copy },
+    { "lock_remove_lines", run_lock_remove_lines },
+    { "game_copy",         run_game_copy },
+    { "hard_drop",         run_hard_drop },
+    { "tetris_draw",       run_tetris_draw },
+    { "draw_string",       run_draw_string },
+    { "ssd1306_show",      run_show },
+    { "ssd1306_show_full", run_show_full },
+};
+#define NUM_CASES ((int)(sizeof(cases) / sizeof(cases[0])))
+
+// -------------------------------------------------------------------
+// Medição
+// -------------------------------------------------------------------
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void measure(const BenchCase *c, int samples, BenchResult *out) {
+    // Calibração: dobra as ops até uma amostra passar de MIN_SAMPLE_S
+    uint64_t ops = 1;
+    for(;;){
+        double t0 = now_s();
+        c->run(ops);
+        if(now_s() - t0 >= MIN_SAMPLE_S || ops >= (1ull << 40)) break;
+        ops *= 2;
+    }
+
+    double ns[MAX_SAMPLES];
+    uint64_t bytes0 = hal_host_i2c_bytes();
+    uint64_t trans0 = hal_host_i2c_transactions();
+    for(int s=0; s<samples; s++){
+        double t0 = now_s();
+        c->run(ops);
+        ns[s] = (now_s() - t0) * 1e9 / (double)ops;
+    }
+    double total_ops = (double)ops * samples;
+    out->i2c_bytes        = (double)(hal_host_i2c_bytes() - bytes0) / total_ops;
+    out->i2c_transactions = (double)(hal_host_i2c_transactions() - trans0) / total_ops;
+
+    double sum = 0, sq = 0;
+    for(int s=0; s<samples; s++) sum += ns[s];
+    out->mean = sum / samples;
+    for(int s=0; s<samples; s++) sq += (ns[s] - out->mean) * (ns[s] - out->mean);
+    out->stddev = samples > 1 ? sqrt(sq / (samples - 1)) : 0.0;
+
+    qsort(ns, (size_t)samples, sizeof(double), cmp_double);
+    out->ops    = ops;
+    out->min    = ns[0];
+    out->median = samples & 1 ? ns[samples / 2] : (ns[samples / 2 - 1] + ns[samples / 2]) / 2;
+}
+
+static void print_table_header(void) {
+    printf("%-18s %10s %10s %10s %8s %10s %8s\n",
+           "caso", "mediana", "min", "media", "dp%", "bytes/op", "trans/op");
+}
+
+static void print_row(const BenchCase *c, const BenchResult *r) {
+    printf("%-18s %8.1fns %8.1fns %8.1fns %7.1f%%",
+           c->name, r->median, r->min, r->mean, 100.0 * r->stddev / r->mean);
+    if(r->i2c_transactions > 0) printf(" %10.1f %8.2f", r->i2c_bytes, r->i2c_transactions);
+    printf("\n");
+}
+
+static void write_json(FILE *f, int samples, const int *idx, const BenchResult *res, int n) {
+    fprintf(f, "{\n  \"bench\": \"bench_suite\",\n  \"samples\": %d,\n  \"min_sample_s\": %g,\n",
+            samples, MIN_SAMPLE_S);
+#ifdef __VERSION__
+    fprintf(f, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#ifdef TETRIS_PROFILE
+    fprintf(f, "  \"profile\": true,\n");
+#else
+    fprintf(f, "  \"profile\": false,\n");
+#endif
+    fprintf(f, "  \"cases\": [\n");
+    for(int i=0; i<n; i++){
+        const BenchResult *r = &res[i];
+        fprintf(f, "    {\"name\": \"%s\", \"ops_per_sample\": %llu, "
+                   "\"ns_per_op\": {\"median\": %.3f, \"min\": %.3f, \"mean\": %.3f, \"stddev\": %.3f}, "
+                   "\"i2c_bytes_per_op\": %.3f, \"i2c_transactions_per_op\": %.3f}%s\n",
+                cases[idx[i]].name, (unsigned long long)r->ops,
+                r->median, r->min, r->mean, r->stddev,
+                r->i2c_bytes, r->i2c_transactions, i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "uso: %s [-n amostras] [-j arquivo.json|-] [filtro]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    int samples = DEFAULT_SAMPLES;
+    const char *json = NULL;
+
+    int opt;
+    while((opt = getopt(argc, argv, "n:j:h")) != -1){
+        switch(opt){
+        case 'n': samples = atoi(optarg); break;
+        case 'j': json = optarg; break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    const char *filter = optind < argc ? argv[optind] : NULL;
+    if(samples < 1) samples = 1;
+    if(samples > MAX_SAMPLES) samples = MAX_SAMPLES;
+    bool table = !(json && strcmp(json, "-") == 0);
+
+    setup();
+
+    int idx[NUM_CASES];
+    BenchResult res[NUM_CASES];
+    int n = 0;
+    if(table) print_table_header();
+    for(int c=0; c<NUM_CASES; c++){
+        if(filter && !strstr(cases[c].name, filter)) continue;
+        measure(&cases[c], samples, &res[n]);
+        if(table) print_row(&cases[c], &res[n]);
+        idx[n++] = c;
+    }
+    if(n == 0){
+        fprintf(stderr, "nenhum caso com '%s'\n", filter);
+        return 2;
+    }
+
+    if(json){
+        FILE *f = table ? fopen(json, "w") : stdout;
+        if(!f){
+            perror(json);
+            return 1;
+        }
+        write_json(f, samples, idx, res, n);
+        if(f != stdout) fclose(f);
+    }
+    return 0;
+}
@@ -1,34 +1,151 @@
 #include "buzzer.h"
-#include "pico/stdlib.h"
-#include "hardware/pwm.h"
+#include <stddef.h>
+#include "hal.h"
 
 // Defina os pinos para cada buzzer (conforme sua tabela):
 #define BUZZER_A_PIN 21  // Buzzer-A (opcional)
 #define BUZZER_B_PIN 10  // Buzzer-B
 
-// Variáveis estáticas para armazenar o número da slice de PWM para cada buzzer
-static uint buzzer_a_slice;
-static uint buzzer_b_slice;
+#define BUZZER_WRAP  4095 // 12 bits de resolução
+#define BUZZER_DUTY  2048 // 50%
+
+typedef struct {
+    uint8_t       pin;
+    buzzer_note_t queue[BUZZER_QUEUE_LEN];
+    uint8_t       head;
+    uint8_t       count;
+    bool          playing;
+    uint64_t      end_us;  // fim da nota atual
+} buzzer_state_t;
+
+static buzzer_state_t channels[BUZZER_NUM_CHANNELS] = {
+    [BUZZER_A] = { .pin = BUZZER_A_PIN },
+    [BUZZER_B] = { .pin = BUZZER_B_PIN },
+};
+
+static void alarm_handler(void *user);
+
+static void channel_init(buzzer_state_t *c) {
+    hal_pwm_init(c->pin, BUZZER_WRAP);
+    c->head    = 0;
+    c->count   = 0;
+    c->playing = false;
+}
+
+/** Tira a próxima nota da fila e a coloca no PWM a partir de start_us. */
+static void start_next(buzzer_state_t *c, uint64_t start_us) {
+    buzzer_note_t n = c->queue[c->head];
+    c->head = (uint8_t)((c->head + 1) % BUZZER_QUEUE_LEN);
+    c->count--;
+
+    if(n.freq){
+        // Calcula divisor aproximado: clock_hz / (4096 * freq)
+        float divisor = (float)hal_sys_clock_hz() / (4096.0f * n.freq);
+        hal_pwm_set_clkdiv(c->pin, divisor);
+        hal_pwm_set_level(c->pin, BUZZER_DUTY);
+    } else {
+        hal_pwm_set_level(c->pin, 0);
+    }
+    c->playing = true;
+    c->end_us  = start_us + (uint64_t)n.duration_ms * 1000u;
+}
+
+/**
+ * Avança os canais cujas notas terminaram até 'now' e reagenda o alarme
+ * para a próxima fronteira. Deve rodar com as interrupções desabilitadas
+ * (ou dentro do próprio alarme).
+ */
+static void service(uint64_t now) {
+    uint64_t next = UINT64_MAX;
+    for(int i=0; i<BUZZER_NUM_CHANNELS; i++){
+        buzzer_state_t *c = &channels[i];
+        while(c->playing && c->end_us <= now){
+            if(c->count){
+                // encadeia a partir do fim exato da nota anterior (sem deriva)
+                start_next(c, c->end_us);
+            } else {
+                hal_pwm_set_level(c->pin, 0);
+                c->playing = false;
+            }
+        }
+        if(c->playing && c->end_us < next) next = c->end_us;
+    }
+
+    if(next != UINT64_MAX){
+        hal_alarm_set(HAL_ALARM_BUZZER, next, alarm_handler, NULL);
+    } else {
+        hal_alarm_clear(HAL_ALARM_BUZZER);
+    }
+}
+
+static void alarm_handler(void *user) {
+    (void)user;
+    service(hal_time_us());
+}
+
+static bool push(buzzer_state_t *c, uint16_t freq, uint16_t duration_ms) {
+    if(c->count == BUZZER_QUEUE_LEN) return false;
+    uint8_t tail = (uint8_t)((c->head + c->count) % BUZZER_QUEUE_LEN);
+    c->queue[tail].freq        = freq;
+    c->queue[tail].duration_ms = duration_ms;
+    c->count++;
+    return true;
+}
+
+void buzzer_play(buzzer_channel_t ch, uint16_t freq, uint16_t duration_ms) {
+    buzzer_state_t *c = &channels[ch];
+    uint32_t irq = hal_irq_save();
+    uint64_t now = hal_time_us();
+    c->head  = 0;
+    c->count = 0;
+    push(c, freq, duration_ms);
+    start_next(c, now);
+    service(now);
+    hal_irq_restore(irq);
+}
+
+bool buzzer_enqueue(buzzer_channel_t ch, uint16_t freq, uint16_t duration_ms) {
+    buzzer_state_t *c = &channels[ch];
+    uint32_t irq = hal_irq_save();
+    bool ok = push(c, freq, duration_ms);
+    if(ok && !c->playing){
+        uint64_t now = hal_time_us();
+        start_next(c, now);
+        service(now);
+    }
+    hal_irq_restore(irq);
+    return ok;
+}
+
+int buzzer_enqueue_sequence(buzzer_channel_t ch, const buzzer_note_t *notes, int count) {
+    int n = 0;
+    while(n < count && buzzer_enqueue(ch, notes[n].freq, notes[n].duration_ms)) n++;
+    return n;
+}
+
+void buzzer_stop(buzzer_channel_t ch) {
+    buzzer_state_t *c = &channels[ch];
+    uint32_t irq = hal_irq_save();
+    c->head    = 0;
+    c->count   = 0;
+    c->playing = false;
+    hal_pwm_set_level(c->pin, 0);
+    service(hal_time_us());
+    hal_irq_restore(irq);
+}
+
+bool buzzer_busy(buzzer_channel_t ch) {
+    const buzzer_state_t *c = &channels[ch];
+    return c->playing || c->count;
+}
 
 void buzzer_a_init(void) {
     // Inicializa o Buzzer-A no GPIO21
-    gpio_set_function(BUZZER_A_PIN, GPIO_FUNC_PWM);
-    buzzer_a_slice = pwm_gpio_to_slice_num(BUZZER_A_PIN);
-    pwm_set_wrap(buzzer_a_slice, 4095); // 12 bits de resolução
-    pwm_set_chan_level(buzzer_a_slice, pwm_gpio_to_channel(BUZZER_A_PIN), 0);
-    pwm_set_enabled(buzzer_a_slice, true);
+    channel_init(&channels[BUZZER_A]);
 }
 
 void buzzer_a_play_tone(uint16_t freq, uint16_t duration_ms) {
-    uint32_t clock_hz = 125000000; // Frequência do sistema (ajuste conforme necessário)
-    // Calcula divisor aproximado: clock_hz / (4096 * freq)
-    float divisor = (float)clock_hz / (4096 * freq);
-    pwm_set_clkdiv(buzzer_a_slice, divisor);
-    // Define duty cycle de 50%
-    pwm_set_chan_level(buzzer_a_slice, pwm_gpio_to_channel(BUZZER_A_PIN), 2048);
-    sleep_ms(duration_ms);
-    // Desliga o som
-    pwm_set_chan_level(buzzer_a_slice, pwm_gpio_to_channel(BUZZER_A_PIN), 0);
+    buzzer_play(BUZZER_A, freq, duration_ms);
 }
 
 void buzzer_a_beep(void) {
@@ -37,20 +154,11 @@ void buzzer_a_beep(void) {
 
 void buzzer_b_init(void) {
     // Inicializa o Buzzer-B no GPIO10
-    gpio_set_function(BUZZER_B_PIN, GPIO_FUNC_PWM);
-    buzzer_b_slice = pwm_gpio_to_slice_num(BUZZER_B_PIN);
-    pwm_set_wrap(buzzer_b_slice, 4095); // 12 bits
-    pwm_set_chan_level(buzzer_b_slice, pwm_gpio_to_channel(BUZZER_B_PIN), 0);
-    pwm_set_enabled(buzzer_b_slice, true);
+    channel_init(&channels[BUZZER_B]);
 }
 
 void buzzer_b_play_tone(uint16_t freq, uint16_t duration_ms) {
-    uint32_t clock_hz = 125000000;
-    float divisor = (float)clock_hz / (4096 * freq);
-    pwm_set_clkdiv(buzzer_b_slice, divisor);
-    pwm_set_chan_level(buzzer_b_slice, pwm_gpio_to_channel(BUZZER_B_PIN), 2048);
-    sleep_ms(duration_ms);
-    pwm_set_chan_level(buzzer_b_slice, pwm_gpio_to_channel(BUZZER_B_PIN), 0);
+    buzzer_play(BUZZER_B, freq, duration_ms);
 }
 
 void buzzer_b_beep(void) {
@@ -4,6 +4,50 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/**
+ * Os dois buzzers são canais independentes de um sequenciador: cada um
+ * tem uma fila de notas e um alarme de hardware troca nível/divisor do
+ * PWM nas fronteiras das notas. Nenhuma função aqui bloqueia.
+ */
+
+typedef enum {
+    BUZZER_A = 0,
+    BUZZER_B,
+    BUZZER_NUM_CHANNELS
+} buzzer_channel_t;
+
+#define BUZZER_QUEUE_LEN 16
+
+typedef struct {
+    uint16_t freq;        // Hz; 0 = pausa
+    uint16_t duration_ms;
+} buzzer_note_t;
+
+/**
+ * Interrompe o que o canal estiver tocando e inicia o tom agora.
+ */
+void buzzer_play(buzzer_channel_t ch, uint16_t freq, uint16_t duration_ms);
+
+/**
+ * Coloca uma nota no fim da fila do canal. Retorna false se a fila estiver cheia.
+ */
+bool buzzer_enqueue(buzzer_channel_t ch, uint16_t freq, uint16_t duration_ms);
+
+/**
+ * Enfileira uma sequência de notas. Retorna quantas couberam na fila.
+ */
+int buzzer_enqueue_sequence(buzzer_channel_t ch, const buzzer_note_t *notes, int count);
+
+/**
+ * Silencia o canal e descarta a fila.
+ */
+void buzzer_stop(buzzer_channel_t ch);
+
+/**
+ * true enquanto o canal estiver tocando ou tiver notas na fila.
+ */
+bool buzzer_busy(buzzer_channel_t ch);
+
 /**
  * Inicializa o Buzzer-A (por exemplo, no GPIO21)
  */
@@ -11,6 +55,7 @@ void buzzer_a_init(void);
 
 /**
  * Toca um tom no Buzzer-A com a frequência (Hz) por duration_ms milissegundos.
+ * Retorna imediatamente; interrompe o som anterior do canal.
  */
 void buzzer_a_play_tone(uint16_t freq, uint16_t duration_ms);
 
@@ -26,6 +71,7 @@ void buzzer_b_init(void);
 
 /**
  * Toca um tom no Buzzer-B com a frequência (Hz) por duration_ms milissegundos.
+ * Retorna imediatamente; interrompe o som anterior do canal.
  */
 void buzzer_b_play_tone(uint16_t freq, uint16_t duration_ms);
 
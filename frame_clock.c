@@ -0,0 +1,94 @@
+#include "frame_clock.h"
+#include <stdio.h>
+#include <string.h>
+
+void frame_clock_init(FrameClock *fc, uint32_t step_us, uint32_t period_us, uint64_t now_us) {
+    memset(fc, 0, sizeof(*fc));
+    fc->step_us   = step_us;
+    fc->period_us = period_us;
+    // até 4 frames de atraso são recuperados; o resto é descartado
+    fc->max_steps = 4 * (period_us / step_us);
+    fc->max_skips = 3;
+    fc->last_us   = now_us;
+    fc->frame_start_us = now_us;
+}
+
+uint32_t frame_clock_begin(FrameClock *fc, uint64_t now_us) {
+    fc->acc_us += now_us - fc->last_us;
+    fc->last_us = now_us;
+    fc->frame_start_us = now_us;
+
+    uint64_t max_acc = (uint64_t)fc->max_steps * fc->step_us + fc->slept_us;
+    fc->slept_us = 0;
+    if(fc->acc_us > max_acc){
+        fc->stats.dropped_us += fc->acc_us - max_acc;
+        fc->acc_us = max_acc;
+    }
+
+    uint32_t steps = (uint32_t)(fc->acc_us / fc->step_us);
+    fc->acc_us -= (uint64_t)steps * fc->step_us;
+    fc->stats.steps += steps;
+    return steps;
+}
+
+bool frame_clock_should_render(FrameClock *fc, uint64_t now_us) {
+    bool over_budget = (now_us - fc->frame_start_us) > fc->period_us;
+    if(over_budget && fc->skips < fc->max_skips){
+        fc->skips++;
+        fc->stats.skipped_renders++;
+        return false;
+    }
+    fc->skips = 0;
+    fc->stats.renders++;
+    return true;
+}
+
+void frame_clock_unchanged(FrameClock *fc) {
+    // nada ficou para trás: não conta como render pulado
+    fc->skips = 0;
+    fc->stats.unchanged++;
+}
+
+void frame_clock_resync(FrameClock *fc, uint64_t now_us) {
+    fc->last_us = now_us;
+    fc->frame_start_us = now_us;
+    fc->acc_us = 0;
+    fc->slept_us = 0;
+}
+
+uint32_t frame_clock_end(FrameClock *fc, uint64_t now_us) {
+    uint32_t work = (uint32_t)(now_us - fc->frame_start_us);
+    fc->stats.frames++;
+    fc->stats.last_frame_us   = work;
+    fc->stats.total_frame_us += work;
+    if(work > fc->stats.max_frame_us) fc->stats.max_frame_us = work;
+
+    return work < fc->period_us ? fc->period_us - work : 0;
+}
+
+uint64_t frame_clock_sim_deadline(const FrameClock *fc, uint64_t sim_us) {
+    if(sim_us == UINT64_MAX) return UINT64_MAX;
+    // last_us - acc_us: até onde a simulação já chegou
+    uint64_t steps = (sim_us + fc->step_us - 1) / fc->step_us;
+    return fc->last_us - fc->acc_us + steps * fc->step_us;
+}
+
+void frame_clock_slept_until(FrameClock *fc, uint64_t wake_us) {
+    uint64_t period_end = fc->frame_start_us + fc->period_us;
+    fc->slept_us = wake_us > period_end ? wake_us - period_end : 0;
+}
+
+const FrameStats *frame_clock_stats(const FrameClock *fc) {
+    return &fc->stats;
+}
+
+void frame_clock_print(const FrameClock *fc) {
+    const FrameStats *s = &fc->stats;
+    uint32_t mean = s->frames ? (uint32_t)(s->total_frame_us / s->frames) : 0;
+    printf("FRAME frames=%u steps=%u renders=%u skipped=%u unchanged=%u dropped_us=%llu "
+           "work_us(last/mean/max)=%u/%u/%u\n",
+           (unsigned)s->frames, (unsigned)s->steps, (unsigned)s->renders,
+           (unsigned)s->skipped_renders, (unsigned)s->unchanged,
+           (unsigned long long)s->dropped_us,
+           (unsigned)s->last_frame_us, (unsigned)mean, (unsigned)s->max_frame_us);
+}
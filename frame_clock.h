@@ -0,0 +1,76 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Relógio de passo fixo para o laço principal. A simulação avança em
+ * passos de step_us com o resto acumulado de um frame para o outro; a
+ * renderização roda no máximo uma vez por frame e é pulada quando o
+ * frame já estourou o orçamento.
+ */
+
+typedef struct {
+    uint32_t frames;
+    uint32_t steps;
+    uint32_t renders;
+    uint32_t skipped_renders;
+    uint32_t unchanged;         // frames sem nada novo para desenhar
+    uint64_t dropped_us;        // tempo descartado pelo limite de passos
+
+    uint32_t last_frame_us;     // duração do trabalho do último frame
+    uint32_t max_frame_us;
+    uint64_t total_frame_us;
+} FrameStats;
+
+typedef struct {
+    uint32_t step_us;      // passo fixo da simulação
+    uint32_t period_us;    // período alvo do frame (e orçamento de trabalho)
+    uint32_t max_steps;    // passos por frame antes de descartar tempo
+    uint8_t  max_skips;    // renders pulados seguidos antes de forçar um
+
+    uint64_t last_us;      // início do frame anterior
+    uint64_t frame_start_us;
+    uint64_t acc_us;       // tempo ainda não simulado
+    uint8_t  skips;
+    uint64_t slept_us;     // espera pedida além do período (não é atraso)
+
+    FrameStats stats;
+} FrameClock;
+
+void frame_clock_init(FrameClock *fc, uint32_t step_us, uint32_t period_us, uint64_t now_us);
+
+/** Começa um frame e retorna quantos passos fixos simular. */
+uint32_t frame_clock_begin(FrameClock *fc, uint64_t now_us);
+
+/** true se ainda cabe renderizar neste frame (conta o render ou o pulo). */
+bool frame_clock_should_render(FrameClock *fc, uint64_t now_us);
+
+/** Frame em que o estado visível não mudou: não há o que renderizar. */
+void frame_clock_unchanged(FrameClock *fc);
+
+/** Descarta o tempo desde o início do frame (pausas intencionais, ex.: game over). */
+void frame_clock_resync(FrameClock *fc, uint64_t now_us);
+
+/** Fecha o frame e retorna quanto dormir (us) até o próximo. */
+uint32_t frame_clock_end(FrameClock *fc, uint64_t now_us);
+
+/**
+ * Instante em que a simulação terá avançado sim_us além do já simulado
+ * (arredondado para cima ao passo); UINT64_MAX para sim_us = UINT64_MAX.
+ */
+uint64_t frame_clock_sim_deadline(const FrameClock *fc, uint64_t sim_us);
+
+/**
+ * O laço dormiu até wake_us de propósito: o que passar do período não é
+ * descartado pelo limite de passos no próximo frame_clock_begin.
+ */
+void frame_clock_slept_until(FrameClock *fc, uint64_t wake_us);
+
+const FrameStats *frame_clock_stats(const FrameClock *fc);
+
+/** Imprime as estatísticas numa linha (stdio/USB). */
+void frame_clock_print(const FrameClock *fc);
+
+#endif
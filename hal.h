@@ -0,0 +1,193 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Camada fina de acesso ao hardware. hal_pico.c implementa sobre o
+ * Pico SDK; hal_host.c implementa backends simulados para rodar no Linux
+ * (ver hal_host.h).
+ */
+
+// -------------------------------------------------------------------
+// Sistema
+// -------------------------------------------------------------------
+
+/** Inicializa stdio e o que mais o backend precisar. */
+void hal_init(void);
+
+/** false quando o backend pede para o laço principal terminar (só no host). */
+bool hal_running(void);
+
+/** Próximo caractere recebido no stdio sem bloquear; -1 se não houver. */
+int hal_getchar(void);
+
+/** Semente para partidas: entropia de hardware no Pico, fixa no host (repetível). */
+uint32_t hal_random_seed(void);
+
+// -------------------------------------------------------------------
+// Tempo
+// -------------------------------------------------------------------
+
+/** Microssegundos desde o boot. */
+uint64_t hal_time_us(void);
+
+/**
+ * Relógio para medir trabalho (prof.h). No Pico é o mesmo de hal_time_us;
+ * no host é o relógio monotônico real, já que o de hal_time_us é simulado.
+ */
+uint64_t hal_perf_us(void);
+
+/** Frequência atual do clock do sistema (Hz). */
+uint32_t hal_sys_clock_hz(void);
+
+/**
+ * Clock do sistema em 1/HAL_CLOCK_REDUCED_DIV (telas paradas, game over)
+ * ou de volta ao normal. Os timers não mudam e a taxa dos barramentos
+ * I2C iniciados é recalculada para o clock novo. O PWM anda no clk_sys:
+ * chamar só com o I2C parado (nada em hal_i2c_write_async) e sem nota
+ * tocando, já que os divisores em uso não são refeitos.
+ */
+#define HAL_CLOCK_REDUCED_DIV 4
+void hal_set_clock_reduced(bool reduced);
+
+void hal_sleep_ms(uint32_t ms);
+void hal_sleep_us(uint64_t us);
+
+/**
+ * Dorme (WFE) até t_us ou até a próxima interrupção, o que vier antes;
+ * true se chegou a t_us. Chamar em laço conferindo o que a IRQ produz.
+ */
+bool hal_wait_until(uint64_t t_us);
+
+// -------------------------------------------------------------------
+// Alarmes (um por slot; o callback roda em contexto de IRQ)
+// -------------------------------------------------------------------
+
+typedef enum {
+    HAL_ALARM_BUZZER = 0,
+    HAL_ALARM_INPUT,
+    HAL_ALARM_COUNT
+} hal_alarm_slot_t;
+
+typedef void (*hal_alarm_cb_t)(void *user);
+
+/**
+ * Agenda cb(user) para o instante absoluto at_us, substituindo o anterior
+ * do slot. Um instante já passado dispara na hora; o callback pode
+ * reagendar o próprio slot.
+ */
+void hal_alarm_set(hal_alarm_slot_t slot, uint64_t at_us,
+                   hal_alarm_cb_t cb, void *user);
+
+/** Cancela o alarme pendente do slot (se houver). */
+void hal_alarm_clear(hal_alarm_slot_t slot);
+
+/** Seção crítica contra os callbacks de alarme. */
+uint32_t hal_irq_save(void);
+void     hal_irq_restore(uint32_t state);
+
+// -------------------------------------------------------------------
+// Segundo core (uma thread no host)
+// -------------------------------------------------------------------
+
+typedef void (*hal_core1_entry_t)(void);
+
+/** Roda entry() no core1; chamar uma vez. */
+void hal_core1_launch(hal_core1_entry_t entry);
+
+/** Acorda o outro core se estiver (ou for entrar) em hal_core_wait. */
+void hal_core_signal(void);
+
+/** Dorme até um hal_core_signal; pode retornar antes, chamar em laço. */
+void hal_core_wait(void);
+
+// -------------------------------------------------------------------
+// PWM (endereçado pelo pino)
+// -------------------------------------------------------------------
+
+void hal_pwm_init(uint8_t pin, uint16_t wrap);
+void hal_pwm_set_clkdiv(uint8_t pin, float div);
+void hal_pwm_set_level(uint8_t pin, uint16_t level);
+
+// -------------------------------------------------------------------
+// GPIO
+// -------------------------------------------------------------------
+
+void hal_gpio_init_input(uint8_t pin, bool pull_up);
+void hal_gpio_init_output(uint8_t pin, bool value);
+void hal_gpio_put(uint8_t pin, bool value);
+bool hal_gpio_get(uint8_t pin);
+
+/** Callback de borda: nível depois da borda e instante lido na entrada da IRQ. */
+typedef void (*hal_gpio_irq_cb_t)(uint8_t pin, bool level, uint64_t time_us);
+
+/** Chama cb (contexto de IRQ) a cada borda de subida e de descida do pino. */
+void hal_gpio_set_irq(uint8_t pin, hal_gpio_irq_cb_t cb);
+
+// -------------------------------------------------------------------
+// ADC
+// -------------------------------------------------------------------
+
+void hal_adc_init(void);
+void hal_adc_gpio_init(uint8_t pin);
+
+/** Leitura única (12 bits) da entrada 'input' (0..3). */
+uint16_t hal_adc_read(uint8_t input);
+
+/**
+ * Amostragem contínua round-robin das entradas 0..num_inputs-1, a
+ * sample_hz no total, para o buffer circular 'ring' (no Pico, dois canais
+ * de DMA, sem fim): ring[i] é sempre da entrada i % num_inputs. len é potência de 2 e
+ * múltiplo de num_inputs; ring alinhado a len * 2 bytes. Depois disto
+ * hal_adc_read não pode mais ser usada.
+ */
+void hal_adc_stream_start(uint8_t num_inputs, uint32_t sample_hz,
+                          volatile uint16_t *ring, size_t len);
+
+/** Pausa/retoma a amostragem de hal_adc_stream_start; o anel segue de onde parou. */
+void hal_adc_stream_run(bool run);
+
+// -------------------------------------------------------------------
+// I2C (bus = 0 ou 1)
+// -------------------------------------------------------------------
+
+void hal_i2c_init(uint8_t bus, uint32_t baudrate, uint8_t sda, uint8_t scl);
+
+/**
+ * Escrita bloqueante; retorna bytes escritos ou < 0 em erro. Não chamar
+ * com uma escrita de hal_i2c_write_async em andamento no mesmo barramento.
+ */
+int hal_i2c_write(uint8_t bus, uint8_t addr,
+                  const uint8_t *src, size_t len, bool nostop);
+
+/**
+ * Palavra de hal_i2c_write_async: o byte fica nos bits 0..7 e
+ * HAL_I2C_STOP fecha a transação depois dele (o mesmo formato do
+ * IC_DATA_CMD do RP2040, que a DMA escreve direto).
+ */
+#define HAL_I2C_STOP (1u << 9)
+
+/** Fim de uma escrita de hal_i2c_write_async (contexto de IRQ no Pico). */
+typedef void (*hal_i2c_done_cb_t)(void *user);
+
+/**
+ * Escrita em segundo plano de uma sequência de transações para 'addr'
+ * (DMA alimentando o FIFO de TX no Pico). A última palavra precisa de
+ * HAL_I2C_STOP; 'words' não pode mudar até cb, chamado quando o último
+ * STOP sai no barramento (ou a escrita é abortada por NACK). Retorna
+ * false se o barramento já tem uma escrita em andamento. No Pico as IRQs
+ * ficam no core da primeira chamada (cb roda nele e o WFE dele é que
+ * acorda): todas as escritas assíncronas do barramento devem sair desse
+ * mesmo core. No host a escrita é síncrona e cb roda antes do retorno.
+ */
+bool hal_i2c_write_async(uint8_t bus, uint8_t addr,
+                         const uint16_t *words, size_t len,
+                         hal_i2c_done_cb_t cb, void *user);
+
+/** true enquanto a escrita de hal_i2c_write_async do barramento não terminou. */
+bool hal_i2c_busy(uint8_t bus);
+
+#endif
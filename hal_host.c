@@ -0,0 +1,459 @@
+/**
+ * Backend de hal.h para o Linux: relógio simulado, alarmes disparados por
+ * hal_host_advance_us e periféricos que só guardam estado (ver hal_host.h).
+ */
+#include "hal_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <time.h>
+
+#define HOST_SYS_CLOCK_HZ 125000000u
+#define HOST_I2C_MAX_TRANSACTION 4096
+#define MONKEY_PERIOD_US 33000 // um frame do laço principal
+
+// lido também pela thread do core1
+static _Atomic uint64_t now_us = 0;
+static uint64_t limit_us = 0;
+static volatile sig_atomic_t interrupted = 0;
+
+static uint32_t seed_counter = 1234;
+
+static bool     monkey = false;
+static uint32_t monkey_rng;
+static uint64_t monkey_next_us = 0;
+static bool     clock_reduced = false;
+
+typedef struct {
+    bool           armed;
+    uint64_t       at_us;
+    hal_alarm_cb_t cb;
+    void          *user;
+} host_alarm_t;
+
+static host_alarm_t alarms[HAL_ALARM_COUNT];
+
+typedef struct {
+    uint16_t wrap;
+    uint16_t level;
+    float    clkdiv;
+} host_pwm_t;
+
+static host_pwm_t pwm[HAL_HOST_NUM_PINS];
+static hal_host_pwm_hook_t pwm_hook = NULL;
+
+static bool     gpio_level[HAL_HOST_NUM_PINS];
+static hal_gpio_irq_cb_t gpio_irq_cb[HAL_HOST_NUM_PINS];
+static uint16_t adc_value[HAL_HOST_NUM_ADC] = { 2048, 2048, 2048, 2048 };
+
+// "DMA" do ADC: o anel é preenchido com os valores atuais a cada avanço do relógio
+static volatile uint16_t *adc_ring = NULL;
+static size_t  adc_ring_len;
+static uint8_t adc_ring_inputs;
+
+static hal_host_i2c_hook_t i2c_hook = NULL;
+static uint64_t i2c_bytes = 0;
+static uint64_t i2c_transactions = 0;
+
+// -------------------------------------------------------------------
+// Sistema
+// -------------------------------------------------------------------
+
+static void on_sigint(int sig) {
+    (void)sig;
+    interrupted = 1;
+}
+
+void hal_init(void) {
+    const char *secs = getenv("TETRIS_HOST_SECONDS");
+    if(secs) limit_us = (uint64_t)(atof(secs) * 1e6);
+    const char *sd = getenv("TETRIS_HOST_SEED");
+    if(sd) seed_counter = (uint32_t)strtoul(sd, NULL, 0);
+    const char *mk = getenv("TETRIS_HOST_MONKEY");
+    if(mk){
+        monkey = true;
+        monkey_rng = (uint32_t)strtoul(mk, NULL, 0) | 1u;
+    }
+    signal(SIGINT, on_sigint);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+bool hal_running(void) {
+    if(interrupted) return false;
+    return limit_us == 0 || now_us < limit_us;
+}
+
+int hal_getchar(void) {
+    struct pollfd p = { .fd = STDIN_FILENO, .events = POLLIN };
+    unsigned char c;
+    if(poll(&p, 1, 0) <= 0 || !(p.revents & POLLIN)) return -1;
+    if(read(STDIN_FILENO, &c, 1) != 1) return -1;
+    return c;
+}
+
+uint32_t hal_random_seed(void) {
+    // sequência fixa (TETRIS_HOST_SEED, TETRIS_HOST_SEED+1, ...) para runs repetíveis
+    return seed_counter++;
+}
+
+void hal_host_set_time_limit_us(uint64_t limit) {
+    limit_us = limit;
+}
+
+// -------------------------------------------------------------------
+// Tempo e alarmes
+// -------------------------------------------------------------------
+
+uint64_t hal_time_us(void) {
+    return now_us;
+}
+
+uint64_t hal_perf_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint32_t hal_sys_clock_hz(void) {
+    return clock_reduced ? HOST_SYS_CLOCK_HZ / HAL_CLOCK_REDUCED_DIV : HOST_SYS_CLOCK_HZ;
+}
+
+void hal_set_clock_reduced(bool reduced) {
+    clock_reduced = reduced;
+}
+
+static uint32_t monkey_next(void) {
+    // xorshift32
+    monkey_rng ^= monkey_rng << 13;
+    monkey_rng ^= monkey_rng >> 17;
+    monkey_rng ^= monkey_rng << 5;
+    return monkey_rng;
+}
+
+// Entradas aleatórias: a cada MONKEY_PERIOD_US simulados (no máximo),
+// cada botão/eixo é sorteado de novo com ~1/8 de chance; botões ficam
+// pressionados (nível 0) 1/4 das vezes.
+static void set_level(uint8_t pin, bool value);
+
+static void monkey_step(void) {
+    static const uint8_t buttons[] = { 5, 6, 22 };
+    if(now_us < monkey_next_us) return;
+    monkey_next_us = now_us + MONKEY_PERIOD_US;
+    for(size_t i=0; i<sizeof(buttons); i++){
+        if((monkey_next() & 7) == 0) set_level(buttons[i], (monkey_next() & 3) != 0);
+    }
+    for(uint8_t in=0; in<2; in++){
+        if((monkey_next() & 7) == 0){
+            static const uint16_t levels[] = { 200, 2048, 2048, 3900 };
+            adc_value[in] = levels[monkey_next() & 3];
+        }
+    }
+}
+
+void hal_sleep_ms(uint32_t ms) {
+    hal_sleep_us((uint64_t)ms * 1000u);
+}
+
+void hal_sleep_us(uint64_t us) {
+    if(monkey) monkey_step();
+    hal_host_advance_us(us);
+}
+
+// O "WFE" acorda no próximo alarme (a IRQ que acordaria o core) ou em t_us
+bool hal_wait_until(uint64_t t_us) {
+    if(monkey) monkey_step();
+    uint64_t until = t_us;
+    for(int i=0; i<HAL_ALARM_COUNT; i++){
+        if(alarms[i].armed && alarms[i].at_us < until) until = alarms[i].at_us;
+    }
+    if(until > now_us) hal_host_advance_us(until - now_us);
+    else hal_host_advance_us(0); // alarme já vencido: dispara agora
+    return now_us >= t_us;
+}
+
+// -------------------------------------------------------------------
+// Segundo core: uma thread; o evento do SEV/WFE vira flag + condvar.
+// O relógio simulado só anda com o core1 parado no WFE e sem evento
+// pendente (core1_sync): o trabalho dele não gasta tempo simulado, como
+// o do laço principal, e as estatísticas dele valem no tempo simulado.
+// -------------------------------------------------------------------
+
+static pthread_t       core1_thread;
+static pthread_mutex_t core_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  core_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  parked_cond = PTHREAD_COND_INITIALIZER;
+static bool            core_event = false;
+static bool            core1_running = false;
+static bool            core1_parked  = false; // em hal_core_wait, sem trabalho
+
+static void *core1_trampoline(void *arg) {
+    ((hal_core1_entry_t)arg)();
+    pthread_mutex_lock(&core_mutex);
+    core1_running = false;
+    pthread_cond_broadcast(&parked_cond);
+    pthread_mutex_unlock(&core_mutex);
+    return NULL;
+}
+
+void hal_core1_launch(hal_core1_entry_t entry) {
+    core1_running = true;
+    pthread_create(&core1_thread, NULL, core1_trampoline, (void *)entry);
+    pthread_detach(core1_thread);
+}
+
+// Espera o core1 esvaziar o que recebeu até agora e voltar ao WFE
+static void core1_sync(void) {
+    pthread_mutex_lock(&core_mutex);
+    while(core1_running && (core_event || !core1_parked)){
+        pthread_cond_wait(&parked_cond, &core_mutex);
+    }
+    pthread_mutex_unlock(&core_mutex);
+}
+
+void hal_core_signal(void) {
+    pthread_mutex_lock(&core_mutex);
+    core_event = true;
+    pthread_cond_signal(&core_cond);
+    pthread_mutex_unlock(&core_mutex);
+}
+
+void hal_core_wait(void) {
+    // timeout curto para o core1 perceber hal_running() == false
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 1000000;
+    if(ts.tv_nsec >= 1000000000){
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&core_mutex);
+    if(!core_event){
+        core1_parked = true;
+        pthread_cond_broadcast(&parked_cond);
+        pthread_cond_timedwait(&core_cond, &core_mutex, &ts);
+        core1_parked = false;
+    }
+    core_event = false;
+    pthread_mutex_unlock(&core_mutex);
+}
+
+void hal_alarm_set(hal_alarm_slot_t slot, uint64_t at_us,
+                   hal_alarm_cb_t cb, void *user)
+{
+    alarms[slot].armed = true;
+    alarms[slot].at_us = at_us;
+    alarms[slot].cb    = cb;
+    alarms[slot].user  = user;
+}
+
+void hal_alarm_clear(hal_alarm_slot_t slot) {
+    alarms[slot].armed = false;
+}
+
+uint32_t hal_irq_save(void) {
+    return 0;
+}
+
+void hal_irq_restore(uint32_t state) {
+    (void)state;
+}
+
+static void fill_adc_ring(void) {
+    if(!adc_ring) return;
+    for(size_t i=0; i<adc_ring_len; i++) adc_ring[i] = adc_value[i % adc_ring_inputs];
+}
+
+void hal_host_advance_us(uint64_t us) {
+    core1_sync();
+    // as entradas mudam no começo do intervalo; os alarmes do caminho veem o anel novo
+    fill_adc_ring();
+    uint64_t target = now_us + us;
+    while(true){
+        host_alarm_t *next = NULL;
+        for(int i=0; i<HAL_ALARM_COUNT; i++){
+            host_alarm_t *a = &alarms[i];
+            if(a->armed && a->at_us <= target && (!next || a->at_us < next->at_us)){
+                next = a;
+            }
+        }
+        if(!next) break;
+        if(next->at_us > now_us) now_us = next->at_us;
+        next->armed = false;
+        next->cb(next->user);
+    }
+    now_us = target;
+}
+
+// -------------------------------------------------------------------
+// PWM
+// -------------------------------------------------------------------
+
+static void pwm_changed(uint8_t pin) {
+    if(pwm_hook) pwm_hook(pin, now_us, pwm[pin].level, pwm[pin].clkdiv);
+}
+
+void hal_pwm_init(uint8_t pin, uint16_t wrap) {
+    pwm[pin].wrap   = wrap;
+    pwm[pin].level  = 0;
+    pwm[pin].clkdiv = 1.0f;
+    pwm_changed(pin);
+}
+
+void hal_pwm_set_clkdiv(uint8_t pin, float div) {
+    pwm[pin].clkdiv = div;
+    pwm_changed(pin);
+}
+
+void hal_pwm_set_level(uint8_t pin, uint16_t level) {
+    pwm[pin].level = level;
+    pwm_changed(pin);
+}
+
+uint16_t hal_host_pwm_level(uint8_t pin) {
+    return pwm[pin].level;
+}
+
+float hal_host_pwm_clkdiv(uint8_t pin) {
+    return pwm[pin].clkdiv;
+}
+
+void hal_host_set_pwm_hook(hal_host_pwm_hook_t hook) {
+    pwm_hook = hook;
+}
+
+// -------------------------------------------------------------------
+// GPIO
+// -------------------------------------------------------------------
+
+void hal_gpio_init_input(uint8_t pin, bool pull_up) {
+    gpio_level[pin] = pull_up;
+}
+
+void hal_gpio_init_output(uint8_t pin, bool value) {
+    gpio_level[pin] = value;
+}
+
+// Toda mudança de nível passa por aqui para disparar a "IRQ" de borda
+static void set_level(uint8_t pin, bool value) {
+    if(gpio_level[pin] == value) return;
+    gpio_level[pin] = value;
+    if(gpio_irq_cb[pin]) gpio_irq_cb[pin](pin, value, now_us);
+}
+
+void hal_gpio_put(uint8_t pin, bool value) {
+    set_level(pin, value);
+}
+
+bool hal_gpio_get(uint8_t pin) {
+    return gpio_level[pin];
+}
+
+void hal_gpio_set_irq(uint8_t pin, hal_gpio_irq_cb_t cb) {
+    gpio_irq_cb[pin] = cb;
+}
+
+void hal_host_set_gpio(uint8_t pin, bool value) {
+    set_level(pin, value);
+}
+
+bool hal_host_gpio(uint8_t pin) {
+    return gpio_level[pin];
+}
+
+// -------------------------------------------------------------------
+// ADC
+// -------------------------------------------------------------------
+
+void hal_adc_init(void) {
+}
+
+void hal_adc_gpio_init(uint8_t pin) {
+    (void)pin;
+}
+
+uint16_t hal_adc_read(uint8_t input) {
+    return adc_value[input];
+}
+
+void hal_adc_stream_start(uint8_t num_inputs, uint32_t sample_hz,
+                          volatile uint16_t *ring, size_t len)
+{
+    (void)sample_hz;
+    adc_ring_inputs = num_inputs;
+    adc_ring_len    = len;
+    adc_ring        = ring;
+    fill_adc_ring();
+}
+
+void hal_adc_stream_run(bool run) {
+    (void)run; // o anel do host é preenchido a cada avanço do relógio
+}
+
+void hal_host_set_adc(uint8_t input, uint16_t value) {
+    adc_value[input] = value;
+    fill_adc_ring();
+}
+
+// -------------------------------------------------------------------
+// I2C
+// -------------------------------------------------------------------
+
+void hal_i2c_init(uint8_t bus, uint32_t baudrate, uint8_t sda, uint8_t scl) {
+    (void)bus; (void)baudrate; (void)sda; (void)scl;
+}
+
+int hal_i2c_write(uint8_t bus, uint8_t addr,
+                  const uint8_t *src, size_t len, bool nostop)
+{
+    (void)nostop;
+    i2c_bytes += len;
+    i2c_transactions++;
+    if(i2c_hook) i2c_hook(bus, addr, src, len);
+    return (int)len;
+}
+
+// Síncrona: cada transação vira um hal_i2c_write (contadores e hook) e cb
+// roda antes do retorno, então o barramento nunca fica ocupado
+bool hal_i2c_write_async(uint8_t bus, uint8_t addr,
+                         const uint16_t *words, size_t len,
+                         hal_i2c_done_cb_t cb, void *user)
+{
+    uint8_t tx[HOST_I2C_MAX_TRANSACTION];
+    size_t n = 0;
+    for(size_t i=0; i<len; i++){
+        n = (words[i] & HAL_I2C_STOP) ? 0 : n + 1;
+        if(n >= sizeof(tx)) return false;
+    }
+    n = 0;
+    for(size_t i=0; i<len; i++){
+        tx[n++] = (uint8_t)words[i];
+        if(words[i] & HAL_I2C_STOP){
+            hal_i2c_write(bus, addr, tx, n, false);
+            n = 0;
+        }
+    }
+    if(n) hal_i2c_write(bus, addr, tx, n, false); // sem STOP final: fecha mesmo assim
+    if(cb) cb(user);
+    return true;
+}
+
+bool hal_i2c_busy(uint8_t bus) {
+    (void)bus;
+    return false;
+}
+
+void hal_host_set_i2c_hook(hal_host_i2c_hook_t hook) {
+    i2c_hook = hook;
+}
+
+uint64_t hal_host_i2c_bytes(void) {
+    return i2c_bytes;
+}
+
+uint64_t hal_host_i2c_transactions(void) {
+    return i2c_transactions;
+}
@@ -0,0 +1,55 @@
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <stdint.h>
+#include "hal.h"
+
+/**
+ * Controles do backend simulado (hal_host.c). O tempo só anda quando
+ * hal_host_advance_us (ou hal_sleep_ms) é chamado, e os alarmes vencidos
+ * disparam em ordem dentro dele, cada um no seu próprio instante. Assim o
+ * laço principal roda no Linux tão rápido quanto a CPU permite. Antes de
+ * avançar, espera a thread do core1 voltar ao hal_core_wait sem trabalho
+ * pendente: o core1 também roda em tempo simulado zero.
+ *
+ * hal_init lê do ambiente:
+ *   TETRIS_HOST_SECONDS   depois desse tempo simulado hal_running retorna false
+ *   TETRIS_HOST_MONKEY    semente; a cada hal_sleep_ms botões e joystick
+ *                         recebem valores aleatórios (carga realista sem placa)
+ */
+
+#define HAL_HOST_NUM_PINS 30
+#define HAL_HOST_NUM_ADC  4
+
+/** Avança o relógio simulado disparando os alarmes no caminho. */
+void hal_host_advance_us(uint64_t us);
+
+/** Estado atual do PWM de um pino. */
+uint16_t hal_host_pwm_level(uint8_t pin);
+float    hal_host_pwm_clkdiv(uint8_t pin);
+
+/** Chamado a cada mudança de nível/divisor, com o instante simulado. */
+typedef void (*hal_host_pwm_hook_t)(uint8_t pin, uint64_t time_us,
+                                    uint16_t level, float clkdiv);
+void hal_host_set_pwm_hook(hal_host_pwm_hook_t hook);
+
+/** Limite de tempo simulado para hal_running (0 = sem limite). */
+void hal_host_set_time_limit_us(uint64_t limit_us);
+
+/** Nível lido por hal_gpio_get / escrito por hal_gpio_put; mudanças disparam hal_gpio_set_irq. */
+void hal_host_set_gpio(uint8_t pin, bool value);
+bool hal_host_gpio(uint8_t pin);
+
+/** Valor de hal_adc_read e do anel de hal_adc_stream_start (padrão: 2048, joystick centrado). */
+void hal_host_set_adc(uint8_t input, uint16_t value);
+
+/** Recebe cada transação de hal_i2c_write. */
+typedef void (*hal_host_i2c_hook_t)(uint8_t bus, uint8_t addr,
+                                    const uint8_t *src, size_t len);
+void hal_host_set_i2c_hook(hal_host_i2c_hook_t hook);
+
+/** Totais de hal_i2c_write desde o início. */
+uint64_t hal_host_i2c_bytes(void);
+uint64_t hal_host_i2c_transactions(void);
+
+#endif
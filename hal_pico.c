@@ -0,0 +1,378 @@
+#include "hal.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/rand.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/gpio.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+
+// -------------------------------------------------------------------
+// Sistema
+// -------------------------------------------------------------------
+
+void hal_init(void) {
+    stdio_init_all();
+}
+
+bool hal_running(void) {
+    return true;
+}
+
+int hal_getchar(void) {
+    int c = getchar_timeout_us(0);
+    return c < 0 ? -1 : c;
+}
+
+uint32_t hal_random_seed(void) {
+    return get_rand_32();
+}
+
+// -------------------------------------------------------------------
+// Tempo
+// -------------------------------------------------------------------
+
+uint64_t hal_time_us(void) {
+    return time_us_64();
+}
+
+uint64_t hal_perf_us(void) {
+    return time_us_64();
+}
+
+uint32_t hal_sys_clock_hz(void) {
+    return clock_get_hz(clk_sys);
+}
+
+static i2c_inst_t *i2c_bus(uint8_t bus);
+static uint32_t i2c_baudrate[2]; // de hal_i2c_init (0 = barramento não iniciado)
+
+// O clk_peri sai do clk_sys no boot; para o clk_sys poder ser dividido
+// sem mexer nele, passa a sair direto do PLL_SYS na primeira troca
+void hal_set_clock_reduced(bool reduced) {
+    static uint32_t pll_hz = 0;
+    if(!pll_hz){
+        pll_hz = clock_get_hz(clk_sys);
+        clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS,
+                        pll_hz, pll_hz);
+    }
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS,
+                    pll_hz, reduced ? pll_hz / HAL_CLOCK_REDUCED_DIV : pll_hz);
+
+    // SCL_HCNT/LCNT são contados em ciclos de clk_sys
+    for(uint8_t bus=0; bus<2; bus++){
+        if(i2c_baudrate[bus]) i2c_set_baudrate(i2c_bus(bus), i2c_baudrate[bus]);
+    }
+}
+
+void hal_sleep_ms(uint32_t ms) {
+    sleep_ms(ms);
+}
+
+void hal_sleep_us(uint64_t us) {
+    sleep_us(us);
+}
+
+bool hal_wait_until(uint64_t t_us) {
+    // um alarme do SDK dá o SEV no prazo; qualquer IRQ antes também acorda
+    return best_effort_wfe_or_timeout(from_us_since_boot(t_us));
+}
+
+// -------------------------------------------------------------------
+// Segundo core
+// -------------------------------------------------------------------
+
+void hal_core1_launch(hal_core1_entry_t entry) {
+    multicore_launch_core1(entry);
+}
+
+void hal_core_signal(void) {
+    __sev();
+}
+
+void hal_core_wait(void) {
+    // um SEV anterior deixa o evento armado: o WFE retorna na hora
+    __wfe();
+}
+
+// -------------------------------------------------------------------
+// Alarmes
+// -------------------------------------------------------------------
+
+typedef struct {
+    alarm_id_t     id;
+    uint32_t       armed; // conta os hal_alarm_set do slot
+    hal_alarm_cb_t cb;
+    void          *user;
+} hal_alarm_t;
+
+static hal_alarm_t alarms[HAL_ALARM_COUNT];
+
+static int64_t alarm_trampoline(alarm_id_t id, void *user_data) {
+    (void)id;
+    hal_alarm_t *a = (hal_alarm_t *)user_data;
+    // já disparou: o callback pode reagendar o próprio slot
+    a->id = 0;
+    a->cb(a->user);
+    return 0;
+}
+
+void hal_alarm_set(hal_alarm_slot_t slot, uint64_t at_us,
+                   hal_alarm_cb_t cb, void *user)
+{
+    // sem IRQ entre agendar e guardar o id: só o disparo síncrono abaixo
+    // pode rodar o callback no meio
+    uint32_t irq = save_and_disable_interrupts();
+    hal_alarm_t *a = &alarms[slot];
+    if(a->id > 0) cancel_alarm(a->id);
+    a->id   = 0;
+    a->cb   = cb;
+    a->user = user;
+    uint32_t armed = ++a->armed;
+    // instante já passado: add_alarm_at chama o callback antes de
+    // retornar, e se ele reagendou o slot o id guardado é o novo
+    alarm_id_t id = add_alarm_at(from_us_since_boot(at_us), alarm_trampoline, a, true);
+    if(id > 0 && a->armed == armed) a->id = id;
+    restore_interrupts(irq);
+}
+
+void hal_alarm_clear(hal_alarm_slot_t slot) {
+    uint32_t irq = save_and_disable_interrupts();
+    hal_alarm_t *a = &alarms[slot];
+    if(a->id > 0) cancel_alarm(a->id);
+    a->id = 0;
+    restore_interrupts(irq);
+}
+
+uint32_t hal_irq_save(void) {
+    return save_and_disable_interrupts();
+}
+
+void hal_irq_restore(uint32_t state) {
+    restore_interrupts(state);
+}
+
+// -------------------------------------------------------------------
+// PWM
+// -------------------------------------------------------------------
+
+void hal_pwm_init(uint8_t pin, uint16_t wrap) {
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    uint slice = pwm_gpio_to_slice_num(pin);
+    pwm_set_wrap(slice, wrap);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(pin), 0);
+    pwm_set_enabled(slice, true);
+}
+
+void hal_pwm_set_clkdiv(uint8_t pin, float div) {
+    pwm_set_clkdiv(pwm_gpio_to_slice_num(pin), div);
+}
+
+void hal_pwm_set_level(uint8_t pin, uint16_t level) {
+    pwm_set_chan_level(pwm_gpio_to_slice_num(pin), pwm_gpio_to_channel(pin), level);
+}
+
+// -------------------------------------------------------------------
+// GPIO
+// -------------------------------------------------------------------
+
+void hal_gpio_init_input(uint8_t pin, bool pull_up) {
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    if(pull_up) gpio_pull_up(pin);
+}
+
+void hal_gpio_init_output(uint8_t pin, bool value) {
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_OUT);
+    gpio_put(pin, value);
+}
+
+void hal_gpio_put(uint8_t pin, bool value) {
+    gpio_put(pin, value);
+}
+
+bool hal_gpio_get(uint8_t pin) {
+    return gpio_get(pin);
+}
+
+// O SDK tem um só callback de GPIO por core; o despacho por pino é aqui
+static hal_gpio_irq_cb_t gpio_irq_cb[NUM_BANK0_GPIOS];
+
+static void gpio_irq_trampoline(uint gpio, uint32_t events) {
+    uint64_t t = time_us_64();
+    bool level = (events & GPIO_IRQ_EDGE_RISE) && (events & GPIO_IRQ_EDGE_FALL)
+               ? gpio_get(gpio)
+               : (events & GPIO_IRQ_EDGE_RISE) != 0;
+    if(gpio_irq_cb[gpio]) gpio_irq_cb[gpio]((uint8_t)gpio, level, t);
+}
+
+void hal_gpio_set_irq(uint8_t pin, hal_gpio_irq_cb_t cb) {
+    gpio_irq_cb[pin] = cb;
+    gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                                       cb != NULL, gpio_irq_trampoline);
+}
+
+// -------------------------------------------------------------------
+// ADC
+// -------------------------------------------------------------------
+
+void hal_adc_init(void) {
+    adc_init();
+}
+
+void hal_adc_gpio_init(uint8_t pin) {
+    adc_gpio_init(pin);
+}
+
+uint16_t hal_adc_read(uint8_t input) {
+    adc_select_input(input);
+    return adc_read();
+}
+
+void hal_adc_stream_start(uint8_t num_inputs, uint32_t sample_hz,
+                          volatile uint16_t *ring, size_t len)
+{
+    adc_select_input(0);
+    adc_set_round_robin((1u << num_inputs) - 1u);
+    adc_fifo_setup(true, true, 1, false, false); // DREQ a cada amostra
+    adc_set_clkdiv(48000000.0f / (float)sample_hz - 1.0f);
+
+    // escrita em anel sobre ring; ao fim da contagem o canal encadeia o
+    // de recarga, que reescreve a contagem e o dispara de novo (o endereço
+    // de escrita segue no anel): o fluxo não termina
+    static uint32_t reload_count = 0xFFFFFFFFu;
+    int ch     = dma_claim_unused_channel(true);
+    int reload = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config((uint)ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, (uint)__builtin_ctz((unsigned)(len * sizeof(uint16_t))));
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, (uint)reload);
+    dma_channel_configure((uint)ch, &c, ring, &adc_hw->fifo, reload_count, false);
+
+    dma_channel_config r = dma_channel_get_default_config((uint)reload);
+    channel_config_set_transfer_data_size(&r, DMA_SIZE_32);
+    channel_config_set_read_increment(&r, false);
+    channel_config_set_write_increment(&r, false);
+    dma_channel_configure((uint)reload, &r, &dma_hw->ch[ch].al1_transfer_count_trig,
+                          &reload_count, 1, false);
+
+    dma_channel_start((uint)ch);
+    adc_run(true);
+}
+
+void hal_adc_stream_run(bool run) {
+    adc_run(run);
+}
+
+// -------------------------------------------------------------------
+// I2C
+// -------------------------------------------------------------------
+
+static i2c_inst_t *i2c_bus(uint8_t bus) {
+    return bus ? i2c1 : i2c0;
+}
+
+void hal_i2c_init(uint8_t bus, uint32_t baudrate, uint8_t sda, uint8_t scl) {
+    i2c_baudrate[bus] = baudrate;
+    i2c_init(i2c_bus(bus), baudrate);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+}
+
+int hal_i2c_write(uint8_t bus, uint8_t addr,
+                  const uint8_t *src, size_t len, bool nostop)
+{
+    return i2c_write_blocking(i2c_bus(bus), addr, src, len, nostop);
+}
+
+// Escrita em segundo plano: a DMA copia as palavras (byte + STOP) para o
+// IC_DATA_CMD a cada DREQ de TX. Ela termina quando a última palavra entra
+// no FIFO; o fim no barramento é um STOP com a DMA parada e o FIFO vazio,
+// conferido a cada STOP_DET.
+typedef struct {
+    int               dma_ch; // -1 até o primeiro uso
+    volatile bool     busy;
+    hal_i2c_done_cb_t cb;
+    void             *user;
+} hal_i2c_async_t;
+
+static hal_i2c_async_t i2c_async[2] = { { .dma_ch = -1 }, { .dma_ch = -1 } };
+
+static void i2c_async_irq(uint8_t bus) {
+    hal_i2c_async_t *a = &i2c_async[bus];
+    i2c_hw_t *hw = i2c_get_hw(i2c_bus(bus));
+    if(!a->busy){
+        hw->intr_mask = 0;
+        return;
+    }
+
+    if(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS){
+        // NACK: o FIFO já foi descartado; para a DMA antes de liberar o TX
+        dma_channel_abort((uint)a->dma_ch);
+        (void)hw->clr_tx_abrt;
+    } else {
+        (void)hw->clr_stop_det;
+        if(dma_channel_is_busy((uint)a->dma_ch)) return;
+        if(!(hw->status & I2C_IC_STATUS_TFE_BITS)) return;
+        if(hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS) return;
+    }
+    hw->intr_mask = 0;
+    a->busy = false;
+    if(a->cb) a->cb(a->user);
+}
+
+static void i2c0_async_irq(void) { i2c_async_irq(0); }
+static void i2c1_async_irq(void) { i2c_async_irq(1); }
+
+bool hal_i2c_write_async(uint8_t bus, uint8_t addr,
+                         const uint16_t *words, size_t len,
+                         hal_i2c_done_cb_t cb, void *user)
+{
+    hal_i2c_async_t *a = &i2c_async[bus];
+    if(a->busy) return false;
+
+    i2c_inst_t *i2c = i2c_bus(bus);
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    if(a->dma_ch < 0){
+        a->dma_ch = dma_claim_unused_channel(true);
+        hw->intr_mask = 0; // o reset deixa várias fontes desmascaradas
+        uint irq = bus ? I2C1_IRQ : I2C0_IRQ;
+        irq_set_exclusive_handler(irq, bus ? i2c1_async_irq : i2c0_async_irq);
+        irq_set_enabled(irq, true);
+    }
+    a->cb   = cb;
+    a->user = user;
+    a->busy = true;
+
+    // o alvo só muda com o bloco desligado (como em i2c_write_blocking)
+    hw->enable = 0;
+    hw->tar    = addr;
+    hw->enable = 1;
+    (void)hw->clr_intr;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+
+    // i2c_init já deixa o DREQ de TX ligado (IC_DMA_CR)
+    dma_channel_config c = dma_channel_get_default_config((uint)a->dma_ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure((uint)a->dma_ch, &c, &hw->data_cmd, words, len, true);
+    return true;
+}
+
+bool hal_i2c_busy(uint8_t bus) {
+    return i2c_async[bus].busy;
+}
@@ -0,0 +1,61 @@
+#include "idle_sched.h"
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+
+static void clear_deadlines(IdleSched *s) {
+    for(int i=0; i<IDLE_WAKE_LIMIT; i++) s->deadline[i] = IDLE_NEVER;
+}
+
+void idle_sched_init(IdleSched *s, uint64_t now_us) {
+    memset(s, 0, sizeof(*s));
+    clear_deadlines(s);
+    s->window_start_us = now_us;
+}
+
+void idle_sched_at(IdleSched *s, IdleWake src, uint64_t at_us) {
+    if(at_us < s->deadline[src]) s->deadline[src] = at_us;
+}
+
+uint64_t idle_sched_deadline(const IdleSched *s, uint64_t now_us, IdleWake *src) {
+    uint64_t at = now_us + IDLE_MAX_SLEEP_US;
+    IdleWake which = IDLE_WAKE_LIMIT;
+    for(int i=0; i<IDLE_WAKE_LIMIT; i++){
+        if(s->deadline[i] < at){
+            at = s->deadline[i];
+            which = (IdleWake)i;
+        }
+    }
+    if(src) *src = which;
+    return at;
+}
+
+IdleWake idle_sched_sleep(IdleSched *s, uint64_t now_us, bool (*woken)(void)) {
+    IdleWake why;
+    uint64_t at = idle_sched_deadline(s, now_us, &why);
+    clear_deadlines(s);
+
+    bool input = woken();
+    while(!input && !hal_wait_until(at)){
+        input = woken();
+    }
+    if(input) why = IDLE_WAKE_INPUT;
+
+    uint64_t t = hal_time_us();
+    if(t > now_us) s->idle_us += t - now_us;
+    s->wakes[why]++;
+    return why;
+}
+
+void idle_sched_print(IdleSched *s, uint64_t now_us) {
+    uint64_t span = now_us - s->window_start_us;
+    printf("IDLE idle=%.1f%% wakes(frame/gravity/repeat/anim/limit/input)=%u/%u/%u/%u/%u/%u\n",
+           span ? 100.0 * (double)s->idle_us / (double)span : 0.0,
+           (unsigned)s->wakes[IDLE_WAKE_FRAME], (unsigned)s->wakes[IDLE_WAKE_GRAVITY],
+           (unsigned)s->wakes[IDLE_WAKE_REPEAT], (unsigned)s->wakes[IDLE_WAKE_ANIM],
+           (unsigned)s->wakes[IDLE_WAKE_LIMIT],
+           (unsigned)s->wakes[IDLE_WAKE_INPUT]);
+    s->window_start_us = now_us;
+    s->idle_us = 0;
+    memset(s->wakes, 0, sizeof(s->wakes));
+}
@@ -0,0 +1,57 @@
+#ifndef IDLE_SCHED_H
+#define IDLE_SCHED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Espera entre frames: a cada frame o laço informa os prazos de cada
+ * fonte (próximo frame pedido, passo da gravidade, disparo do
+ * auto-repeat...) e idle_sched_sleep dorme com WFE até o mais cedo deles
+ * ou até chegar uma entrada. Sem prazo nenhum o core dorme até
+ * IDLE_MAX_SLEEP_US. Conta o tempo dormido e o motivo de cada despertar.
+ *
+ * O cálculo do prazo não depende do hardware (idle_sched_deadline), e a
+ * espera usa hal_wait_until, que no host anda no relógio simulado.
+ */
+
+#define IDLE_NEVER        UINT64_MAX
+#define IDLE_MAX_SLEEP_US 250000 // o laço ainda olha o stdio e as estatísticas
+
+typedef enum {
+    IDLE_WAKE_FRAME = 0, // próximo frame pedido (IA, snapshot a reenviar...)
+    IDLE_WAKE_GRAVITY,   // passo da gravidade
+    IDLE_WAKE_REPEAT,    // disparo do auto-repeat
+    IDLE_WAKE_ANIM,      // próxima transição de uma animação
+    IDLE_WAKE_LIMIT,     // nenhum prazo antes de IDLE_MAX_SLEEP_US
+    IDLE_WAKE_INPUT,     // entrada antes do prazo
+    IDLE_WAKE_COUNT
+} IdleWake;
+
+typedef struct {
+    uint64_t deadline[IDLE_WAKE_LIMIT]; // por fonte, IDLE_NEVER = sem prazo
+
+    // desde o último idle_sched_print
+    uint64_t window_start_us;
+    uint64_t idle_us;
+    uint32_t wakes[IDLE_WAKE_COUNT];
+} IdleSched;
+
+void idle_sched_init(IdleSched *s, uint64_t now_us);
+
+/** Pede um despertar em at_us pela fonte (fica o mais cedo de cada fonte no frame). */
+void idle_sched_at(IdleSched *s, IdleWake src, uint64_t at_us);
+
+/** Prazo mais cedo a partir de now_us (limitado a IDLE_MAX_SLEEP_US) e a fonte dele. */
+uint64_t idle_sched_deadline(const IdleSched *s, uint64_t now_us, IdleWake *src);
+
+/**
+ * Dorme até o prazo ou até woken() dar true (conferido a cada IRQ) e
+ * limpa os prazos para o próximo frame. Retorna o motivo do despertar.
+ */
+IdleWake idle_sched_sleep(IdleSched *s, uint64_t now_us, bool (*woken)(void));
+
+/** Fração dormida e despertares por motivo desde a última impressão (stdio/USB). */
+void idle_sched_print(IdleSched *s, uint64_t now_us);
+
+#endif
@@ -0,0 +1,200 @@
+#include "input_events.h"
+#include <stdatomic.h>
+#include "hal.h"
+
+#define SLOT(i) ((i) & (INPUT_QUEUE_LEN - 1))
+
+_Static_assert((INPUT_QUEUE_LEN & (INPUT_QUEUE_LEN - 1)) == 0,
+               "INPUT_QUEUE_LEN precisa ser potência de 2");
+
+typedef struct {
+    uint8_t  pin;
+    bool     raw;       // último nível visto numa borda
+    bool     reported;  // último nível publicado na fila
+    uint64_t edge_us;   // instante da última borda
+    uint64_t report_us; // instante da última publicação
+} Button;
+
+static InputEvent       queue[INPUT_QUEUE_LEN];
+static _Atomic uint32_t queue_head, queue_tail;
+static _Atomic uint32_t queue_dropped;
+
+static Button   buttons[INPUT_NUM_BUTTONS];
+static uint8_t  axis_input[INPUT_NUM_AXES];
+static int8_t   axis_zone[INPUT_NUM_AXES];
+static uint8_t  adc_inputs;
+static uint64_t tick_at;
+
+typedef enum {
+    TICK_ACTIVE, // a cada INPUT_TICK_US, ADC amostrando
+    TICK_IDLE,   // ADC parado, próxima olhada em INPUT_IDLE_TICK_US
+    TICK_WARMUP, // ADC religado, esperando a janela do anel encher
+} TickMode;
+
+static TickMode tick_mode;
+
+// O DMA escreve em anel: o buffer precisa estar alinhado ao próprio tamanho
+static volatile uint16_t adc_ring[INPUT_ADC_RING_LEN]
+    __attribute__((aligned(INPUT_ADC_RING_LEN * sizeof(uint16_t))));
+
+// Só as IRQs do core0 produzem, e elas não se interrompem entre si
+static void push(uint64_t t, uint8_t source, int8_t value) {
+    uint32_t head = atomic_load_explicit(&queue_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue_tail, memory_order_acquire);
+    if(head - tail >= INPUT_QUEUE_LEN){
+        atomic_store_explicit(&queue_dropped,
+                              atomic_load_explicit(&queue_dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        return;
+    }
+    InputEvent *ev = &queue[SLOT(head)];
+    ev->time_us = t;
+    ev->source  = source;
+    ev->value   = value;
+    atomic_store_explicit(&queue_head, head + 1, memory_order_release);
+}
+
+static void report(Button *b, uint8_t source, bool level, uint64_t t) {
+    b->reported  = level;
+    b->report_us = t;
+    push(t, source, level ? 0 : 1); // pull-up: nível baixo = apertado
+}
+
+static void tick(void *user);
+
+static void schedule(uint64_t at) {
+    tick_at = at;
+    hal_alarm_set(HAL_ALARM_INPUT, tick_at, tick, NULL);
+}
+
+// Religa o ADC; a filtragem volta quando o anel tiver só amostras novas
+static void warm_up(uint64_t now) {
+    hal_adc_stream_run(true);
+    tick_mode = TICK_WARMUP;
+    schedule(now + INPUT_ADC_WINDOW_US);
+}
+
+static void on_edge(uint8_t pin, bool level, uint64_t t) {
+    if(tick_mode == TICK_IDLE) warm_up(t);
+    for(int i=0; i<INPUT_NUM_BUTTONS; i++){
+        Button *b = &buttons[i];
+        if(b->pin != pin) continue;
+        b->raw = level;
+        b->edge_us = t;
+        if(level != b->reported && t - b->report_us >= INPUT_DEBOUNCE_US){
+            report(b, (uint8_t)i, level, t);
+        }
+        return;
+    }
+}
+
+static int8_t zone(int8_t current, uint32_t v) {
+    if(current < 0 && v < INPUT_AXIS_LOW + INPUT_AXIS_HYST)  return -1;
+    if(current > 0 && v > INPUT_AXIS_HIGH - INPUT_AXIS_HYST) return 1;
+    if(v < INPUT_AXIS_LOW)  return -1;
+    if(v > INPUT_AXIS_HIGH) return 1;
+    return 0;
+}
+
+// Eixos no centro e botões soltos (pull-up: nível alto), sem debounce pendente
+static bool all_released(void) {
+    for(int i=0; i<INPUT_NUM_BUTTONS; i++){
+        if(!buttons[i].raw || !buttons[i].reported) return false;
+    }
+    for(int a=0; a<INPUT_NUM_AXES; a++){
+        if(axis_zone[a]) return false;
+    }
+    return true;
+}
+
+static void tick(void *user) {
+    (void)user;
+    uint64_t now = hal_time_us();
+
+    if(tick_mode == TICK_IDLE){
+        warm_up(now);
+        return;
+    }
+    tick_mode = TICK_ACTIVE;
+
+    // nível que mudou durante o debounce e ficou: publica com o instante da borda
+    for(int i=0; i<INPUT_NUM_BUTTONS; i++){
+        Button *b = &buttons[i];
+        if(b->raw != b->reported && now - b->edge_us >= INPUT_DEBOUNCE_US){
+            report(b, (uint8_t)i, b->raw, b->edge_us);
+        }
+    }
+
+    // média da janela do anel; ring[k] é da entrada k % adc_inputs
+    for(int a=0; a<INPUT_NUM_AXES; a++){
+        uint32_t sum = 0, n = 0;
+        for(uint32_t k=axis_input[a]; k<INPUT_ADC_RING_LEN; k+=adc_inputs){
+            sum += adc_ring[k];
+            n++;
+        }
+        int8_t z = zone(axis_zone[a], sum / n);
+        if(z != axis_zone[a]){
+            axis_zone[a] = z;
+            push(now, (uint8_t)(INPUT_NUM_BUTTONS + a), z);
+        }
+    }
+
+    if(all_released()){
+        // nada a acompanhar: sem amostrar e sem acordar o core a cada 2 ms
+        hal_adc_stream_run(false);
+        tick_mode = TICK_IDLE;
+        schedule(now + INPUT_IDLE_TICK_US);
+        return;
+    }
+
+    uint64_t at = tick_at + INPUT_TICK_US;
+    if(at < now) at = now + INPUT_TICK_US; // IRQs atrasadas: não acumula
+    schedule(at);
+}
+
+void input_events_init(const InputConfig *cfg) {
+    atomic_init(&queue_head, 0);
+    atomic_init(&queue_tail, 0);
+    atomic_init(&queue_dropped, 0);
+
+    uint64_t now = hal_time_us();
+    for(int i=0; i<INPUT_NUM_BUTTONS; i++){
+        Button *b = &buttons[i];
+        b->pin       = cfg->button_pins[i];
+        b->raw       = hal_gpio_get(b->pin);
+        b->reported  = b->raw;
+        b->edge_us   = now;
+        b->report_us = now - INPUT_DEBOUNCE_US;
+        hal_gpio_set_irq(b->pin, on_edge);
+    }
+
+    adc_inputs = 1;
+    for(int a=0; a<INPUT_NUM_AXES; a++){
+        axis_input[a] = cfg->axis_inputs[a];
+        axis_zone[a]  = 0;
+        if(axis_input[a] + 1u > adc_inputs) adc_inputs = (uint8_t)(axis_input[a] + 1);
+    }
+    hal_adc_stream_start(adc_inputs, INPUT_ADC_HZ, adc_ring, INPUT_ADC_RING_LEN);
+
+    tick_mode = TICK_ACTIVE;
+    schedule(now + INPUT_TICK_US);
+}
+
+bool input_events_pending(void) {
+    uint32_t tail = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+    return atomic_load_explicit(&queue_head, memory_order_acquire) != tail;
+}
+
+bool input_events_pop(InputEvent *ev) {
+    uint32_t tail = atomic_load_explicit(&queue_tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue_head, memory_order_acquire);
+    if(head == tail) return false;
+
+    *ev = queue[SLOT(tail)];
+    atomic_store_explicit(&queue_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t input_events_dropped(void) {
+    return atomic_load_explicit(&queue_dropped, memory_order_relaxed);
+}
@@ -0,0 +1,73 @@
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Captura de entrada por interrupção. Cada borda de botão gera uma IRQ
+ * com o instante lido na entrada dela (debounce pela borda de subida:
+ * a primeira borda vale, as seguintes por INPUT_DEBOUNCE_US são
+ * repique). O ADC amostra o joystick sem parar (round-robin + DMA) e um
+ * alarme a cada INPUT_TICK_US tira a média do anel e converte cada eixo
+ * em zona (-1, 0, +1) com histerese.
+ *
+ * Com o joystick no centro e os botões soltos o ADC para e o alarme passa
+ * a INPUT_IDLE_TICK_US: a cada olhada o ADC volta, a janela do anel enche
+ * e a filtragem decide se segue devagar. Uma borda de botão religa na hora.
+ *
+ * Tudo vira InputEvent numa fila sem lock (produtor: IRQs do core0;
+ * consumidor: laço principal), então um toque que começa e termina
+ * dentro de um frame não se perde.
+ */
+
+typedef enum {
+    INPUT_BUTTON_A = 0,
+    INPUT_BUTTON_B,
+    INPUT_BUTTON_JOY,
+    INPUT_NUM_BUTTONS,
+
+    INPUT_AXIS_X = INPUT_NUM_BUTTONS,
+    INPUT_AXIS_Y,
+    INPUT_NUM_SOURCES
+} InputSource;
+
+#define INPUT_NUM_AXES (INPUT_NUM_SOURCES - INPUT_NUM_BUTTONS)
+
+#define INPUT_QUEUE_LEN     32    // potência de 2
+#define INPUT_DEBOUNCE_US   5000
+#define INPUT_TICK_US       2000  // filtragem do joystick
+#define INPUT_ADC_HZ        8000  // amostras/s somando as entradas
+#define INPUT_ADC_RING_LEN  64    // 8 ms de janela por eixo com 2 entradas
+#define INPUT_ADC_WINDOW_US (INPUT_ADC_RING_LEN * 1000000ull / INPUT_ADC_HZ)
+#define INPUT_IDLE_TICK_US  25000 // tudo parado: intervalo entre olhadas no joystick
+
+// Zonas do eixo: entra abaixo de LOW / acima de HIGH, sai com HYST de folga
+#define INPUT_AXIS_LOW      1000
+#define INPUT_AXIS_HIGH     3000
+#define INPUT_AXIS_HYST     200
+
+typedef struct {
+    uint64_t time_us; // instante da borda ou da filtragem que mudou a zona
+    uint8_t  source;  // InputSource
+    int8_t   value;   // botão: 1 apertado, 0 solto; eixo: -1, 0, +1
+} InputEvent;
+
+typedef struct {
+    uint8_t button_pins[INPUT_NUM_BUTTONS]; // com pull-up, apertado = 0
+    uint8_t axis_inputs[INPUT_NUM_AXES];    // entrada do ADC (0..1) de cada eixo
+} InputConfig;
+
+/** Liga as IRQs, a amostragem do ADC e o alarme; pinos e ADC já inicializados. */
+void input_events_init(const InputConfig *cfg);
+
+/** Próximo evento em ordem de chegada; false se a fila estiver vazia. */
+bool input_events_pop(InputEvent *ev);
+
+/** true se há evento na fila (para acordar o laço principal). */
+bool input_events_pending(void);
+
+/** Eventos descartados com a fila cheia. */
+uint32_t input_events_dropped(void);
+
+#endif
@@ -0,0 +1,121 @@
+#include "input_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static const uint8_t MAGIC[4] = { 'T', 'L', 'O', 'G' };
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void input_log_begin(InputLog *log, uint32_t seed, uint8_t randomizer, uint8_t ai_depth) {
+    memset(&log->header, 0, sizeof(log->header));
+    log->header.seed = seed;
+    log->header.randomizer = randomizer;
+    log->header.ai_depth = ai_depth;
+    log->size = 0;
+}
+
+void input_log_record(InputLog *log, uint32_t dt_ms, uint8_t actions) {
+    if(log->header.flags & INPUT_LOG_FLAG_TRUNCATED) return;
+
+    uint8_t rec[6];
+    size_t  n = 0;
+    uint32_t v = (dt_ms << 1) | (actions ? 1u : 0u);
+    do {
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        rec[n++] = (uint8_t)(b | (v ? 0x80 : 0));
+    } while(v);
+    if(actions) rec[n++] = actions;
+
+    if(log->size + n > INPUT_LOG_CAPACITY){
+        log->header.flags |= INPUT_LOG_FLAG_TRUNCATED;
+        return;
+    }
+    memcpy(&log->data[log->size], rec, n);
+    log->size += n;
+    log->header.frames++;
+}
+
+void input_log_finish(InputLog *log, uint32_t final_score, uint32_t final_hash) {
+    log->header.final_score = final_score;
+    log->header.final_hash  = final_hash;
+}
+
+static void write_header(const InputLogHeader *h, uint8_t *out) {
+    memset(out, 0, INPUT_LOG_HEADER_SIZE);
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out[4] = INPUT_LOG_VERSION;
+    out[5] = h->flags;
+    out[6] = h->ai_depth;
+    out[7] = h->randomizer;
+    put_u32(&out[8],  h->seed);
+    put_u32(&out[12], h->frames);
+    put_u32(&out[16], h->final_score);
+    put_u32(&out[20], h->final_hash);
+}
+
+size_t input_log_serialize(const InputLog *log, uint8_t *out, size_t out_size) {
+    size_t total = INPUT_LOG_HEADER_SIZE + log->size;
+    if(total > out_size) return 0;
+
+    write_header(&log->header, out);
+    memcpy(&out[INPUT_LOG_HEADER_SIZE], log->data, log->size);
+    return total;
+}
+
+void input_log_dump(const InputLog *log) {
+    uint8_t hdr[INPUT_LOG_HEADER_SIZE];
+    write_header(&log->header, hdr);
+
+    printf("TLOG ");
+    for(size_t i=0; i<sizeof(hdr); i++) printf("%02x", hdr[i]);
+    for(size_t i=0; i<log->size; i++) printf("%02x", log->data[i]);
+    printf("\n");
+}
+
+bool input_log_reader_init(InputLogReader *r, const uint8_t *buf, size_t len) {
+    if(len < INPUT_LOG_HEADER_SIZE) return false;
+    if(memcmp(buf, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if(buf[4] != INPUT_LOG_VERSION) return false;
+
+    r->header.flags       = buf[5];
+    r->header.ai_depth    = buf[6];
+    r->header.randomizer  = buf[7];
+    r->header.seed        = get_u32(&buf[8]);
+    r->header.frames      = get_u32(&buf[12]);
+    r->header.final_score = get_u32(&buf[16]);
+    r->header.final_hash  = get_u32(&buf[20]);
+    r->pos = buf + INPUT_LOG_HEADER_SIZE;
+    r->end = buf + len;
+    return true;
+}
+
+bool input_log_next(InputLogReader *r, uint32_t *dt_ms, uint8_t *actions) {
+    uint32_t v = 0;
+    int shift = 0;
+    while(true){
+        if(r->pos >= r->end || shift > 28) return false;
+        uint8_t b = *r->pos++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+        if(!(b & 0x80)) break;
+    }
+
+    *dt_ms   = v >> 1;
+    *actions = 0;
+    if(v & 1){
+        if(r->pos >= r->end) return false;
+        *actions = *r->pos++;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Gravação compacta das entradas de uma partida, para reproduzi-la de
+ * forma determinística (tools/replay.c).
+ *
+ * Formato (little-endian):
+ *   cabeçalho INPUT_LOG_HEADER_SIZE bytes:
+ *     "TLOG", versão (u8), flags (u8), profundidade da IA (u8), sorteio das peças (u8),
+ *     seed (u32), frames (u32), score final (u32), hash final do tabuleiro (u32)
+ *   um registro por frame:
+ *     varint(dt_ms << 1 | tem_acoes) [+ 1 byte TETRIS_ACTION_* se tem_acoes]
+ *
+ * Um frame sem ações e com dt < 64 ms ocupa 1 byte.
+ *
+ * Com profundidade da IA != 0 a partida foi jogada por tetris_ai (pesos
+ * padrão): o replay chama tetris_ai_step depois do dt de cada frame,
+ * como o laço principal.
+ */
+
+#define INPUT_LOG_VERSION     3 // v3: 20G só por opção (INPUT_LOG_FLAG_20G)
+#define INPUT_LOG_HEADER_SIZE 24
+#define INPUT_LOG_CAPACITY    16384 // bytes de registros na gravação
+
+#define INPUT_LOG_FLAG_TRUNCATED (1u << 0) // faltou espaço: o replay não chega ao fim da partida
+#define INPUT_LOG_FLAG_20G       (1u << 1) // partida em 20G (tetris_set_20g)
+
+typedef struct {
+    uint8_t  flags;
+    uint8_t  ai_depth;   // 0 = jogador humano
+    uint8_t  randomizer; // PieceRandomizer passado a tetris_init
+    uint32_t seed;
+    uint32_t frames;
+    uint32_t final_score;
+    uint32_t final_hash;
+} InputLogHeader;
+
+typedef struct {
+    InputLogHeader header;
+    uint8_t  data[INPUT_LOG_CAPACITY];
+    size_t   size;
+} InputLog;
+
+/** Começa uma gravação nova para tetris_init(seed, randomizer) (ai_depth 0 = humano). */
+void input_log_begin(InputLog *log, uint32_t seed, uint8_t randomizer, uint8_t ai_depth);
+
+/** Grava um frame: o dt passado a tetris_update e as ações aplicadas. */
+void input_log_record(InputLog *log, uint32_t dt_ms, uint8_t actions);
+
+/** Fecha a gravação com o resultado da partida. */
+void input_log_finish(InputLog *log, uint32_t final_score, uint32_t final_hash);
+
+/** Serializa cabeçalho + registros em 'out'; retorna o tamanho (0 se não couber). */
+size_t input_log_serialize(const InputLog *log, uint8_t *out, size_t out_size);
+
+/** Imprime o log serializado numa linha "TLOG <hex>" (stdio/USB). */
+void input_log_dump(const InputLog *log);
+
+// -------------------------------------------------------------------
+// Leitura
+// -------------------------------------------------------------------
+
+typedef struct {
+    InputLogHeader header;
+    const uint8_t *pos;
+    const uint8_t *end;
+} InputLogReader;
+
+/** Valida o cabeçalho de um log serializado. */
+bool input_log_reader_init(InputLogReader *r, const uint8_t *buf, size_t len);
+
+/** Próximo frame; false no fim (ou em registro malformado). */
+bool input_log_next(InputLogReader *r, uint32_t *dt_ms, uint8_t *actions);
+
+#endif
@@ -0,0 +1,63 @@
+#include "piece_queue.h"
+
+static uint32_t next_u32(PieceQueue *q) {
+    // xorshift32
+    uint32_t x = q->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    q->rng = x;
+    return x;
+}
+
+/** Inteiro uniforme em [0, n): multiplicação com rejeição (Lemire). */
+static uint32_t next_below(PieceQueue *q, uint32_t n) {
+    uint64_t m = (uint64_t)next_u32(q) * n;
+    uint32_t low = (uint32_t)m;
+    if(low < n){
+        uint32_t threshold = (uint32_t)-n % n;
+        while(low < threshold){
+            m = (uint64_t)next_u32(q) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+static uint8_t draw(PieceQueue *q) {
+    if(q->mode != PIECE_RANDOM_BAG) return (uint8_t)next_below(q, PIECE_QUEUE_TYPES);
+
+    if(q->bag_left == 0){
+        // Fisher-Yates de um saco novo
+        for(int i=0; i<PIECE_QUEUE_TYPES; i++) q->bag[i] = (uint8_t)i;
+        for(int i=PIECE_QUEUE_TYPES-1; i>0; i--){
+            int j = (int)next_below(q, (uint32_t)i + 1);
+            uint8_t t = q->bag[i];
+            q->bag[i] = q->bag[j];
+            q->bag[j] = t;
+        }
+        q->bag_left = PIECE_QUEUE_TYPES;
+    }
+    return q->bag[--q->bag_left];
+}
+
+void piece_queue_init(PieceQueue *q, uint32_t seed, PieceRandomizer mode) {
+    // espalha a semente (finalizador do murmur3) para que 1, 2, 3...
+    // não comecem com estados parecidos; xorshift não aceita zero
+    uint32_t s = seed + 0x9E3779B9u;
+    s ^= s >> 16; s *= 0x85EBCA6Bu;
+    s ^= s >> 13; s *= 0xC2B2AE35u;
+    s ^= s >> 16;
+    q->rng      = s ? s : 1u;
+    q->mode     = (uint8_t)mode;
+    q->bag_left = 0;
+    q->head     = 0;
+    for(int i=0; i<PIECE_QUEUE_LEN; i++) q->ring[i] = draw(q);
+}
+
+int piece_queue_pop(PieceQueue *q) {
+    int type = q->ring[q->head];
+    q->ring[q->head] = draw(q);
+    q->head = (uint8_t)((q->head + 1) & (PIECE_QUEUE_LEN - 1));
+    return type;
+}
@@ -0,0 +1,41 @@
+#ifndef PIECE_QUEUE_H
+#define PIECE_QUEUE_H
+
+#include <stdint.h>
+
+/**
+ * Sequência de peças de uma partida: xorshift32 com semente explícita
+ * (4 bytes de estado, sem o rand() global nem viés de módulo) e uma fila
+ * circular sempre cheia com as próximas PIECE_QUEUE_LEN peças, para
+ * prévia e busca sem copiar o estado do jogo.
+ */
+
+#define PIECE_QUEUE_LEN   8 // potência de 2
+#define PIECE_QUEUE_TYPES 7
+
+typedef enum {
+    PIECE_RANDOM_UNIFORM = 0, // cada peça sorteada de forma independente
+    PIECE_RANDOM_BAG     = 1, // 7-bag: as 7 peças embaralhadas, um saco por vez
+} PieceRandomizer;
+
+typedef struct {
+    uint32_t rng;
+    uint8_t  mode;     // PieceRandomizer
+    uint8_t  bag_left; // peças ainda no saco (modo BAG)
+    uint8_t  bag[PIECE_QUEUE_TYPES];
+    uint8_t  head;     // posição da próxima peça em ring
+    uint8_t  ring[PIECE_QUEUE_LEN];
+} PieceQueue;
+
+/** Semeia o gerador e enche a fila; sementes vizinhas dão sequências sem relação. */
+void piece_queue_init(PieceQueue *q, uint32_t seed, PieceRandomizer mode);
+
+/** Retira a próxima peça (0..6) e sorteia uma nova para o fim da fila. */
+int piece_queue_pop(PieceQueue *q);
+
+/** i-ésima peça da fila sem retirar (0 = a próxima), i < PIECE_QUEUE_LEN. */
+static inline int piece_queue_peek(const PieceQueue *q, int i) {
+    return q->ring[(q->head + i) & (PIECE_QUEUE_LEN - 1)];
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "prof.h"
+
+#ifdef TETRIS_PROFILE
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+static const char *const stage_names[PROF_NUM_STAGES] = {
+    "input", "update", "ai", "actions", "sound", "anim", "snapshot", "render", "show", "idle",
+};
+
+// Mesmo layout de ProfStat; atômicos só para a leitura do outro core
+typedef struct {
+    _Atomic uint32_t count;
+    _Atomic uint32_t min_us;
+    _Atomic uint32_t max_us;
+    _Atomic uint32_t total_us;
+    _Atomic uint32_t hist[PROF_BUCKETS];
+} ProfRow;
+
+static ProfRow table[PROF_NUM_STAGES];
+
+static inline uint32_t get(_Atomic uint32_t *v) {
+    return atomic_load_explicit(v, memory_order_relaxed);
+}
+
+static inline void put(_Atomic uint32_t *v, uint32_t x) {
+    atomic_store_explicit(v, x, memory_order_relaxed);
+}
+
+void prof_record(ProfStage stage, uint32_t us) {
+    ProfRow *r = &table[stage];
+    uint32_t n = get(&r->count);
+    if(n == 0 || us < get(&r->min_us)) put(&r->min_us, us);
+    if(us > get(&r->max_us)) put(&r->max_us, us);
+    put(&r->total_us, get(&r->total_us) + us);
+
+    int b = us ? 32 - __builtin_clz(us) : 0;
+    if(b >= PROF_BUCKETS) b = PROF_BUCKETS - 1;
+    put(&r->hist[b], get(&r->hist[b]) + 1);
+    // count por último: quem lê n > 0 já vê min/max válidos
+    put(&r->count, n + 1);
+}
+
+void prof_stat(ProfStage stage, ProfStat *out) {
+    ProfRow *r = &table[stage];
+    out->count    = get(&r->count);
+    out->min_us   = get(&r->min_us);
+    out->max_us   = get(&r->max_us);
+    out->total_us = get(&r->total_us);
+    for(int b=0; b<PROF_BUCKETS; b++) out->hist[b] = get(&r->hist[b]);
+}
+
+void prof_dump(void) {
+    for(int i=0; i<PROF_NUM_STAGES; i++){
+        ProfStat s;
+        prof_stat((ProfStage)i, &s);
+        if(s.count == 0) continue;
+        printf("PROF %s n=%u us(min/mean/max)=%u/%u/%u hist=",
+               stage_names[i], (unsigned)s.count, (unsigned)s.min_us,
+               (unsigned)(s.total_us / s.count), (unsigned)s.max_us);
+        const char *sep = "";
+        for(int b=0; b<PROF_BUCKETS; b++){
+            if(!s.hist[b]) continue;
+            printf("%s%d:%u", sep, b, (unsigned)s.hist[b]);
+            sep = ",";
+        }
+        printf("\n");
+    }
+}
+
+void prof_reset(void) {
+    // o core1 pode estar gravando: uma amostra pode sobreviver ao reset
+    for(int i=0; i<PROF_NUM_STAGES; i++){
+        ProfRow *r = &table[i];
+        put(&r->count, 0);
+        put(&r->min_us, 0);
+        put(&r->max_us, 0);
+        put(&r->total_us, 0);
+        for(int b=0; b<PROF_BUCKETS; b++) put(&r->hist[b], 0);
+    }
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+#include "hal.h"
+
+/**
+ * Perfil por etapa do frame: cada PROF_BEGIN/PROF_END mede uma etapa em
+ * microssegundos (hal_perf_us) e acumula mínimo, máximo, média e um
+ * histograma log2 numa tabela fixa em RAM. Com TETRIS_PROFILE desligado
+ * as macros somem e nada disto é compilado.
+ *
+ * Cada etapa deve ser medida sempre pelo mesmo core (um escritor por
+ * linha da tabela); prof_dump pode rodar em qualquer um.
+ */
+
+typedef enum {
+    PROF_INPUT = 0, // botões, auto-repeat e ADC do joystick
+    PROF_UPDATE,    // passos de tetris_update
+    PROF_AI,        // tetris_ai_step no modo demonstração
+    PROF_ACTIONS,   // tetris_apply_actions
+    PROF_SOUND,     // play_events (buzzers e LEDs)
+    PROF_ANIM,      // start_animations + anim_update (trilhas das animações)
+    PROF_SNAPSHOT,  // tetris_snapshot + anim_apply + render_core_submit
+    PROF_RENDER,    // core1: tetris_render
+    PROF_SHOW,      // core1: ssd1306_flush_begin (diff + início da DMA)
+    PROF_IDLE,      // sleep até o próximo frame
+    PROF_NUM_STAGES
+} ProfStage;
+
+// Balde k: duração com k bits (0 us, 1 us, 2-3 us, 4-7 us...); o último
+// acumula tudo a partir de 2^(PROF_BUCKETS-2) us (~262 ms)
+#define PROF_BUCKETS 20
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t total_us;
+    uint32_t hist[PROF_BUCKETS];
+} ProfStat;
+
+#ifdef TETRIS_PROFILE
+
+void prof_record(ProfStage stage, uint32_t us);
+
+/** Cópia da linha de uma etapa. */
+void prof_stat(ProfStage stage, ProfStat *out);
+
+/**
+ * Imprime uma linha por etapa medida (stdio/USB):
+ *   PROF <etapa> n=<n> us(min/mean/max)=<a>/<b>/<c> hist=<balde>:<n>,...
+ */
+void prof_dump(void);
+
+/** Zera a tabela (total_us é de 32 bits: zerar a cada partida). */
+void prof_reset(void);
+
+#define PROF_BEGIN(stage)  uint64_t prof_t0_##stage = hal_perf_us()
+#define PROF_END(stage)    prof_record(stage, (uint32_t)(hal_perf_us() - prof_t0_##stage))
+#define PROF_DUMP()        prof_dump()
+#define PROF_RESET()       prof_reset()
+
+#else
+
+#define PROF_BEGIN(stage)  ((void)0)
+#define PROF_END(stage)    ((void)0)
+#define PROF_DUMP()        ((void)0)
+#define PROF_RESET()       ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,96 @@
+#include "render_core.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include "hal.h"
+#include "prof.h"
+#include "snapshot_queue.h"
+#include "tetris_render.h"
+
+static SnapshotQueue queue;
+static ssd1306_t *display;
+static TetrisRenderer renderer;
+
+// Cada contador tem um só escritor; atômicos só para a leitura do outro core
+static _Atomic uint32_t stat_submitted, stat_rejected;
+static _Atomic uint32_t stat_frames, stat_superseded;
+static _Atomic uint32_t stat_last_latency, stat_max_latency;
+
+// release: quem lê o contador (render_core_idle) vê o envio que o precedeu
+static void bump(_Atomic uint32_t *c, uint32_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n,
+                          memory_order_release);
+}
+
+static void core1_main(void) {
+    TetrisSnapshot s;
+    while(hal_running()){
+        // Com um frame no barramento e outro na fila não adianta desenhar:
+        // a IRQ do fim do envio acorda o WFE
+        if(!ssd1306_buffer_available(display)){
+            hal_core_wait();
+            continue;
+        }
+        uint32_t n = snapshot_queue_pop_latest(&queue, &s);
+        if(n == 0){
+            hal_core_wait();
+            continue;
+        }
+        PROF_BEGIN(PROF_RENDER);
+        tetris_render(&renderer, &s, display);
+        PROF_END(PROF_RENDER);
+        PROF_BEGIN(PROF_SHOW);
+        ssd1306_flush_begin(display);
+        PROF_END(PROF_SHOW);
+
+        uint32_t lat = (uint32_t)hal_time_us() - s.stamp_us;
+        atomic_store_explicit(&stat_last_latency, lat, memory_order_relaxed);
+        if(lat > atomic_load_explicit(&stat_max_latency, memory_order_relaxed)){
+            atomic_store_explicit(&stat_max_latency, lat, memory_order_relaxed);
+        }
+        bump(&stat_frames, 1);
+        bump(&stat_superseded, n - 1);
+    }
+}
+
+void render_core_start(ssd1306_t *oled) {
+    display = oled;
+    tetris_renderer_init(&renderer);
+    snapshot_queue_init(&queue);
+    hal_core1_launch(core1_main);
+}
+
+bool render_core_submit(const TetrisSnapshot *s) {
+    if(!snapshot_queue_push(&queue, s)){
+        bump(&stat_rejected, 1);
+        return false;
+    }
+    bump(&stat_submitted, 1);
+    hal_core_signal();
+    return true;
+}
+
+bool render_core_idle(void) {
+    // frames conta depois de ssd1306_flush_begin; superseded logo depois
+    uint32_t done = atomic_load_explicit(&stat_frames, memory_order_acquire)
+                  + atomic_load_explicit(&stat_superseded, memory_order_acquire);
+    if(done != atomic_load_explicit(&stat_submitted, memory_order_relaxed)) return false;
+    return ssd1306_flush_done(display);
+}
+
+void render_core_stats(RenderStats *out) {
+    out->submitted       = atomic_load_explicit(&stat_submitted, memory_order_relaxed);
+    out->rejected        = atomic_load_explicit(&stat_rejected, memory_order_relaxed);
+    out->frames          = atomic_load_explicit(&stat_frames, memory_order_relaxed);
+    out->superseded      = atomic_load_explicit(&stat_superseded, memory_order_relaxed);
+    out->last_latency_us = atomic_load_explicit(&stat_last_latency, memory_order_relaxed);
+    out->max_latency_us  = atomic_load_explicit(&stat_max_latency, memory_order_relaxed);
+}
+
+void render_core_print(void) {
+    RenderStats s;
+    render_core_stats(&s);
+    printf("RENDER submitted=%u rejected=%u frames=%u superseded=%u "
+           "latency_us(last/max)=%u/%u\n",
+           (unsigned)s.submitted, (unsigned)s.rejected, (unsigned)s.frames,
+           (unsigned)s.superseded, (unsigned)s.last_latency_us, (unsigned)s.max_latency_us);
+}
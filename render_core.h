@@ -0,0 +1,44 @@
+#ifndef RENDER_CORE_H
+#define RENDER_CORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ssd1306.h"
+#include "tetris.h"
+
+/**
+ * Render no core1: o core0 só amostra entradas e simula, e entrega a
+ * cada frame um TetrisSnapshot numa fila SPSC (snapshot_queue.h). O core1
+ * desenha sempre o snapshot mais recente (tetris_render.h, só as células
+ * que mudaram) e começa o envio I2C, que segue por DMA enquanto o
+ * próximo frame é desenhado; nenhum dos dois espera pelo outro.
+ */
+
+typedef struct {
+    uint32_t submitted;       // snapshots aceitos na fila (core0)
+    uint32_t rejected;        // fila cheia: snapshot descartado pelo core0
+    uint32_t frames;          // snapshots desenhados e postos no barramento (core1)
+    uint32_t superseded;      // retirados sem desenhar, já havia um mais novo
+    uint32_t last_latency_us; // amostragem da entrada -> início do envio
+    uint32_t max_latency_us;
+} RenderStats;
+
+/** Passa o display ao core1 e o inicia. Depois disso o core0 não toca mais em 'oled'. */
+void render_core_start(ssd1306_t *oled);
+
+/** core0: entrega um snapshot sem bloquear; false se a fila estava cheia. */
+bool render_core_submit(const TetrisSnapshot *s);
+
+/**
+ * core0: true se todo snapshot entregue já foi desenhado e enviado e o
+ * barramento está parado. Sem outro render_core_submit, o core1 não
+ * volta a usar o I2C (janela para trocar o clock, hal_set_clock_reduced).
+ */
+bool render_core_idle(void);
+
+void render_core_stats(RenderStats *out);
+
+/** Imprime as estatísticas numa linha (stdio/USB). */
+void render_core_print(void);
+
+#endif
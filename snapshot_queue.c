@@ -0,0 +1,43 @@
+#include "snapshot_queue.h"
+
+#define SLOT(i) ((i) & (SNAPSHOT_QUEUE_LEN - 1))
+
+_Static_assert((SNAPSHOT_QUEUE_LEN & (SNAPSHOT_QUEUE_LEN - 1)) == 0,
+               "SNAPSHOT_QUEUE_LEN precisa ser potência de 2");
+
+void snapshot_queue_init(SnapshotQueue *q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+}
+
+bool snapshot_queue_push(SnapshotQueue *q, const TetrisSnapshot *s) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if(head - tail >= SNAPSHOT_QUEUE_LEN) return false;
+
+    q->slots[SLOT(head)] = *s;
+    // publica o slot só depois de escrito
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool snapshot_queue_pop(SnapshotQueue *q, TetrisSnapshot *out) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if(head == tail) return false;
+
+    *out = q->slots[SLOT(tail)];
+    // libera o slot só depois de copiado
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t snapshot_queue_pop_latest(SnapshotQueue *q, TetrisSnapshot *out) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if(head == tail) return 0;
+
+    *out = q->slots[SLOT(head - 1)];
+    atomic_store_explicit(&q->tail, head, memory_order_release);
+    return head - tail;
+}
@@ -0,0 +1,41 @@
+#ifndef SNAPSHOT_QUEUE_H
+#define SNAPSHOT_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris.h"
+
+/**
+ * Fila sem lock de um produtor (core0, simulação) e um consumidor
+ * (core1, render). Só usa load/store atômicos de 32 bits com
+ * acquire/release, então funciona no Cortex-M0+ (sem LDREX/STREX) e
+ * entre duas threads no Linux.
+ *
+ * head e tail são contadores livres (nunca voltam a zero antes de dar a
+ * volta em 2^32); o slot é o contador módulo SNAPSHOT_QUEUE_LEN.
+ */
+
+#define SNAPSHOT_QUEUE_LEN 4 // potência de 2
+
+typedef struct {
+    TetrisSnapshot   slots[SNAPSHOT_QUEUE_LEN];
+    _Atomic uint32_t head; // escrito só pelo produtor
+    _Atomic uint32_t tail; // escrito só pelo consumidor
+} SnapshotQueue;
+
+void snapshot_queue_init(SnapshotQueue *q);
+
+/** Produtor: copia 's' para a fila; false (sem esperar) se estiver cheia. */
+bool snapshot_queue_push(SnapshotQueue *q, const TetrisSnapshot *s);
+
+/** Consumidor: retira o mais antigo; false se vazia. */
+bool snapshot_queue_pop(SnapshotQueue *q, TetrisSnapshot *out);
+
+/**
+ * Consumidor: esvazia a fila e fica só com o mais recente. Retorna
+ * quantos foram retirados (0 se vazia; os demais foram descartados).
+ */
+uint32_t snapshot_queue_pop_latest(SnapshotQueue *q, TetrisSnapshot *out);
+
+#endif
@@ -1,19 +1,20 @@
 #include <stdlib.h>
 #include <string.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include "hal.h"
 #include "ssd1306.h"
 #include "font.h"
 
 /** Envia 1 comando */
 void ssd1306_command(ssd1306_t *ssd, uint8_t cmd) {
+    // a escrita bloqueante não pode cruzar um envio em segundo plano
+    while(!ssd1306_flush_done(ssd)) {}
     ssd->port_buffer[0] = 0x80;   // Co=1, D/C#=0 => comando
     ssd->port_buffer[1] = cmd;
-    i2c_write_blocking(ssd->i2c_port,
-                       ssd->address,
-                       ssd->port_buffer,
-                       2,
-                       false);
+    hal_i2c_write(ssd->i2c_bus,
+                  ssd->address,
+                  ssd->port_buffer,
+                  2,
+                  false);
 }
 
 void ssd1306_init(ssd1306_t *ssd,
@@ -21,13 +22,13 @@ void ssd1306_init(ssd1306_t *ssd,
                   uint8_t height,
                   bool external_vcc,
                   uint8_t address,
-                  i2c_inst_t *i2c)
+                  uint8_t i2c_bus)
 {
     ssd->width        = width;
     ssd->height       = height;
     ssd->pages        = height / 8;
     ssd->address      = address;
-    ssd->i2c_port     = i2c;
+    ssd->i2c_bus      = i2c_bus;
     ssd->external_vcc = external_vcc;
 
     ssd->bufsize = ssd->width * ssd->pages + 1; // 1 + width*pages
@@ -36,74 +37,269 @@ void ssd1306_init(ssd1306_t *ssd,
     // Primeiro byte (índice 0) = 0x40 => data
     ssd->ram_buffer[0] = 0x40;
 
+    ssd->shadow = (uint8_t *)calloc(ssd->bufsize - 1, sizeof(uint8_t));
+    ssd->shadow_valid = false;
+
+    // Pior caso: uma janela por página, cada uma com 0x00 + 6 comandos,
+    // o byte de controle 0x40 e a página inteira
+    ssd->tx_cap = (size_t)ssd->pages * (1 + 6 + 1 + ssd->width);
+    ssd->tx[0] = (uint16_t *)calloc(ssd->tx_cap, sizeof(uint16_t));
+    ssd->tx[1] = (uint16_t *)calloc(ssd->tx_cap, sizeof(uint16_t));
+    ssd->tx_sending = SSD1306_TX_NONE;
+    ssd->tx_queued  = SSD1306_TX_NONE;
+    ssd->frame_bytes        = 0;
+    ssd->frame_transactions = 0;
+    ssd->total_bytes        = 0;
+    ssd->total_transactions = 0;
+    ssd->frames             = 0;
+
     // Para enviar comandos, iremos usar port_buffer
     ssd->port_buffer[0] = 0x80;
 }
 
+// -------------------------------------------------------------------
+// Fluxo de comandos (palavras de hal_i2c_write_async). Comandos seguidos
+// vão numa transação só (controle 0x00 + bytes) e os dados de uma janela
+// em outra (0x40 + bytes). Com Co=1 a janela inteira caberia numa
+// transação, mas cada comando levaria um byte de controle: 5 bytes a mais
+// custam mais que uma transação (endereço + start/stop, ~11 bits).
+// -------------------------------------------------------------------
+
+typedef enum { STREAM_NONE, STREAM_CMD, STREAM_DATA } StreamState;
+
+typedef struct {
+    uint16_t   *start;
+    uint16_t   *w;
+    StreamState open;
+    uint32_t    transactions;
+} CmdStream;
+
+static void stream_init(CmdStream *s, uint16_t *buf) {
+    s->start = s->w = buf;
+    s->open = STREAM_NONE;
+    s->transactions = 0;
+}
+
+static void stream_close(CmdStream *s) {
+    if(s->open == STREAM_NONE) return;
+    s->w[-1] |= HAL_I2C_STOP;
+    s->open = STREAM_NONE;
+    s->transactions++;
+}
+
+static void stream_cmd(CmdStream *s, uint8_t cmd) {
+    if(s->open != STREAM_CMD){
+        stream_close(s);
+        *s->w++ = 0x00;           // Co=0, D/C#=0 => comandos até o STOP
+        s->open = STREAM_CMD;
+    }
+    *s->w++ = cmd;
+}
+
+static void stream_data(CmdStream *s, const uint8_t *src, size_t len) {
+    if(s->open != STREAM_DATA){
+        stream_close(s);
+        *s->w++ = 0x40;           // Co=0, D/C#=1 => dados até o STOP
+        s->open = STREAM_DATA;
+    }
+    for(size_t i=0; i<len; i++) *s->w++ = src[i];
+}
+
+/**
+ * Janela [c0,c1] x [p0,p1] de fb: endereçamento numa transação e os
+ * dados, página a página, na seguinte (modo horizontal).
+ */
+static void stream_window(CmdStream *s, const ssd1306_t *ssd, const uint8_t *fb,
+                          uint8_t c0, uint8_t c1, uint8_t p0, uint8_t p1)
+{
+    stream_cmd(s, SET_COL_ADDR);
+    stream_cmd(s, c0);
+    stream_cmd(s, c1);
+    stream_cmd(s, SET_PAGE_ADDR);
+    stream_cmd(s, p0);
+    stream_cmd(s, p1);
+    for(uint8_t p=p0; p<=p1; p++){
+        stream_data(s, fb + p * ssd->width + c0, (size_t)(c1 - c0 + 1));
+    }
+    stream_close(s);
+}
+
+static void start_tx(ssd1306_t *ssd, uint8_t idx);
+
 void ssd1306_config(ssd1306_t *ssd) {
+    while(!ssd1306_flush_done(ssd)) {}
+    CmdStream s;
+    stream_init(&s, ssd->tx[0]);
+
     // Display OFF
-    ssd1306_command(ssd, 0xAE);
+    stream_cmd(&s, 0xAE);
 
     // Memory addressing mode => 0x00 (horizontal)
-    ssd1306_command(ssd, SET_MEM_ADDR);
-    ssd1306_command(ssd, 0x00);
+    stream_cmd(&s, SET_MEM_ADDR);
+    stream_cmd(&s, 0x00);
 
     // Start line = 0
-    ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
+    stream_cmd(&s, SET_DISP_START_LINE | 0x00);
     // Segment remap col127->SEG0
-    ssd1306_command(ssd, SET_SEG_REMAP | 0x00);
+    stream_cmd(&s, SET_SEG_REMAP | 0x00);
 
-    ssd1306_command(ssd, SET_MUX_RATIO);
-    ssd1306_command(ssd, ssd->height -1);
+    stream_cmd(&s, SET_MUX_RATIO);
+    stream_cmd(&s, ssd->height -1);
 
     // COM out direction
-    ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
+    stream_cmd(&s, SET_COM_OUT_DIR | 0x08);
 
-    ssd1306_command(ssd, SET_DISP_OFFSET);
-    ssd1306_command(ssd, 0x00);
+    stream_cmd(&s, SET_DISP_OFFSET);
+    stream_cmd(&s, 0x00);
 
-    ssd1306_command(ssd, SET_COM_PIN_CFG);
-    ssd1306_command(ssd, (ssd->height==64) ? 0x12 : 0x02);
+    stream_cmd(&s, SET_COM_PIN_CFG);
+    stream_cmd(&s, (ssd->height==64) ? 0x12 : 0x02);
 
-    ssd1306_command(ssd, SET_DISP_CLK_DIV);
-    ssd1306_command(ssd, 0x80);
+    stream_cmd(&s, SET_DISP_CLK_DIV);
+    stream_cmd(&s, 0x80);
 
-    ssd1306_command(ssd, SET_PRECHARGE);
-    ssd1306_command(ssd, ssd->external_vcc ? 0x22 : 0xF1);
+    stream_cmd(&s, SET_PRECHARGE);
+    stream_cmd(&s, ssd->external_vcc ? 0x22 : 0xF1);
 
-    ssd1306_command(ssd, SET_VCOM_DESEL);
-    ssd1306_command(ssd, 0x30);
+    stream_cmd(&s, SET_VCOM_DESEL);
+    stream_cmd(&s, 0x30);
 
-    ssd1306_command(ssd, SET_CONTRAST);
-    ssd1306_command(ssd, 0xFF);
+    stream_cmd(&s, SET_CONTRAST);
+    stream_cmd(&s, 0xFF);
 
-    ssd1306_command(ssd, SET_ENTIRE_ON); // normal
-    ssd1306_command(ssd, SET_NORM_INV);  // normal
+    stream_cmd(&s, SET_ENTIRE_ON); // normal
+    stream_cmd(&s, SET_NORM_INV);  // normal
 
-    ssd1306_command(ssd, SET_CHARGE_PUMP);
-    ssd1306_command(ssd, 0x14);
+    stream_cmd(&s, SET_CHARGE_PUMP);
+    stream_cmd(&s, 0x14);
 
     // Display ON
-    ssd1306_command(ssd, 0xAF);
+    stream_cmd(&s, 0xAF);
+    stream_close(&s);
+
+    // uma transação de 26 bytes no lugar de 25 de 2 bytes, bloqueante: a
+    // primeira escrita assíncrona prende a IRQ do I2C ao core que a faz,
+    // e ela tem de ser a do core1 (render_core), não a desta chamada
+    uint8_t bytes[32];
+    size_t len = (size_t)(s.w - s.start);
+    for(size_t i=0; i<len; i++) bytes[i] = (uint8_t)s.start[i];
+    hal_i2c_write(ssd->i2c_bus, ssd->address, bytes, len, false);
+}
+
+// Fim de um envio (IRQ no Pico): passa o da fila para o barramento
+static void tx_done(void *user) {
+    ssd1306_t *ssd = (ssd1306_t *)user;
+    uint8_t next = ssd->tx_queued;
+    ssd->tx_sending = SSD1306_TX_NONE;
+    ssd->tx_queued  = SSD1306_TX_NONE;
+    if(next != SSD1306_TX_NONE) start_tx(ssd, next);
+}
+
+static void start_tx(ssd1306_t *ssd, uint8_t idx) {
+    ssd->tx_sending = idx;
+    if(!hal_i2c_write_async(ssd->i2c_bus, ssd->address,
+                            ssd->tx[idx], ssd->tx_len[idx], tx_done, ssd)){
+        // frame perdido: o painel não é mais o que shadow diz
+        ssd->tx_sending   = SSD1306_TX_NONE;
+        ssd->shadow_valid = false;
+    }
+}
+
+bool ssd1306_flush_done(const ssd1306_t *ssd) {
+    return ssd->tx_sending == SSD1306_TX_NONE && ssd->tx_queued == SSD1306_TX_NONE;
+}
+
+bool ssd1306_buffer_available(const ssd1306_t *ssd) {
+    return ssd->tx_queued == SSD1306_TX_NONE;
+}
+
+// Custo fixo de uma janela em bytes equivalentes: 0x00 + 6 comandos,
+// 0x40 e duas transações
+#define WINDOW_OVERHEAD 10
+
+/** Manda a janela e acerta shadow nela (fora das mudanças fb e shadow já batem). */
+static void flush_window(ssd1306_t *ssd, CmdStream *s, const uint8_t *fb,
+                         int c0, int c1, int p0, int p1)
+{
+    stream_window(s, ssd, fb, (uint8_t)c0, (uint8_t)c1, (uint8_t)p0, (uint8_t)p1);
+    for(int p=p0; p<=p1; p++){
+        memcpy(ssd->shadow + p * ssd->width + c0, fb + p * ssd->width + c0, (size_t)(c1 - c0 + 1));
+    }
+}
+
+/**
+ * Codifica as partes de ram_buffer que diferem do que o painel vai
+ * mostrar: uma faixa de colunas por página alterada, e páginas próximas
+ * numa janela só quando os bytes a mais custam menos que outra janela.
+ */
+bool ssd1306_flush_begin(ssd1306_t *ssd) {
+    if(!ssd1306_buffer_available(ssd)) return false;
+    // com um buffer no barramento e nenhum na fila, o outro está livre
+    uint8_t idx = ssd->tx_sending == 0 ? 1 : 0;
+
+    const uint8_t *fb = ssd->ram_buffer + 1;
+    CmdStream s;
+    stream_init(&s, ssd->tx[idx]);
+
+    if(!ssd->shadow_valid){
+        // conteúdo do painel desconhecido => tela inteira
+        flush_window(ssd, &s, fb, 0, ssd->width -1, 0, ssd->pages -1);
+        ssd->shadow_valid = true;
+    } else {
+        int run_p0 = -1, run_p1 = 0, run_c0 = 0, run_c1 = 0;
+        int run_cost = 0;
+        for(int page=0; page<ssd->pages; page++){
+            const uint8_t *row = fb + page * ssd->width;
+            const uint8_t *sh = ssd->shadow + page * ssd->width;
+
+            int c0 = 0;
+            while(c0 < ssd->width && row[c0] == sh[c0]) c0++;
+            if(c0 == ssd->width) continue; // página sem mudanças
+            int c1 = ssd->width - 1;
+            while(row[c1] == sh[c1]) c1--;
+
+            if(run_p0 >= 0){
+                int u0 = c0 < run_c0 ? c0 : run_c0;
+                int u1 = c1 > run_c1 ? c1 : run_c1;
+                int merged = (u1 - u0 + 1) * (page - run_p0 + 1) + WINDOW_OVERHEAD;
+                if(merged <= run_cost + (c1 - c0 + 1) + WINDOW_OVERHEAD){
+                    run_p1 = page; run_c0 = u0; run_c1 = u1;
+                    run_cost = merged;
+                    continue;
+                }
+                flush_window(ssd, &s, fb, run_c0, run_c1, run_p0, run_p1);
+            }
+            run_p0 = run_p1 = page;
+            run_c0 = c0; run_c1 = c1;
+            run_cost = (c1 - c0 + 1) + WINDOW_OVERHEAD;
+        }
+        if(run_p0 >= 0) flush_window(ssd, &s, fb, run_c0, run_c1, run_p0, run_p1);
+    }
+
+    // shadow já é o que o painel mostra depois dos envios pendentes
+    uint32_t bytes = (uint32_t)(s.w - s.start);
+    ssd->frame_bytes         = bytes;
+    ssd->frame_transactions  = s.transactions;
+    ssd->total_bytes        += bytes;
+    ssd->total_transactions += s.transactions;
+    ssd->frames++;
+    if(bytes == 0) return true;
+
+    ssd->tx_len[idx] = (uint16_t)bytes;
+    uint32_t irq = hal_irq_save();
+    if(ssd->tx_sending == SSD1306_TX_NONE) start_tx(ssd, idx);
+    else ssd->tx_queued = idx;
+    hal_irq_restore(irq);
+    return true;
 }
 
-/** Envia todo o buffer (ram_buffer) */
 void ssd1306_send_data(ssd1306_t *ssd) {
-    // define col range
-    ssd1306_command(ssd, SET_COL_ADDR);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd->width -1);
-
-    // define page range
-    ssd1306_command(ssd, SET_PAGE_ADDR);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd->pages -1);
-
-    i2c_write_blocking(ssd->i2c_port,
-                       ssd->address,
-                       ssd->ram_buffer,
-                       ssd->bufsize,
-                       false);
+    while(!ssd1306_flush_begin(ssd)) {}
+    while(!ssd1306_flush_done(ssd)) {}
+}
+
+void ssd1306_invalidate(ssd1306_t *ssd) {
+    ssd->shadow_valid = false;
 }
 
 // Desenha ou apaga pixel
@@ -131,12 +327,47 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t lx, uint8_t ly, bool value) {
 }
 
 
+/**
+ * Preenche o retângulo LÓGICO [lx0,lx1] x [ly0,ly1] (inclusivo) byte a
+ * byte. A rotação de ssd1306_pixel é aplicada uma vez aos cantos:
+ * ly vira coluna física e lx vira linha física invertida, então o
+ * retângulo cobre as colunas [ly0,ly1] e as linhas [H-1-lx1, H-1-lx0].
+ * Cada página tocada recebe uma máscara (bordas de cima/baixo parciais)
+ * aplicada de uma vez em todas as colunas.
+ */
+static void blit_rect(ssd1306_t *ssd, int lx0, int ly0, int lx1, int ly1, bool value) {
+    // recorte nas coordenadas lógicas: lx < height, ly < width
+    if(lx0 < 0) lx0 = 0;
+    if(ly0 < 0) ly0 = 0;
+    if(lx1 > ssd->height - 1) lx1 = ssd->height - 1;
+    if(ly1 > ssd->width - 1)  ly1 = ssd->width - 1;
+    if(lx0 > lx1 || ly0 > ly1) return;
+
+    int py0 = (ssd->height - 1) - lx1;
+    int py1 = (ssd->height - 1) - lx0;
+    int ncols = ly1 - ly0 + 1;
+    int page0 = py0 >> 3, page1 = py1 >> 3;
+
+    for(int page=page0; page<=page1; page++){
+        uint8_t mask = 0xFF;
+        if(page == page0) mask &= (uint8_t)(0xFF << (py0 & 7));
+        if(page == page1) mask &= (uint8_t)(0xFF >> (7 - (py1 & 7)));
+
+        uint8_t *p = &ssd->ram_buffer[1 + page * ssd->width + ly0];
+        if(mask == 0xFF){
+            memset(p, value ? 0xFF : 0x00, (size_t)ncols);
+        } else if(value){
+            for(int i=0; i<ncols; i++) p[i] |= mask;
+        } else {
+            uint8_t keep = (uint8_t)~mask;
+            for(int i=0; i<ncols; i++) p[i] &= keep;
+        }
+    }
+}
+
 // Preenche a tela com value
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    uint8_t byte_val= value? 0xFF: 0x00;
-    for(size_t i=1; i<ssd->bufsize; i++){
-        ssd->ram_buffer[i]= byte_val;
-    }
+    memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
 }
 
 /** Retângulo com borda e opcional fill. 
@@ -148,33 +379,17 @@ void ssd1306_rect(ssd1306_t *ssd,
                   bool value, bool fill)
 {
     if(w==0 || h==0) return;
-    uint8_t x2 = x+w-1;
-    uint8_t y2 = y+h-1;
+    int x2 = x+w-1;
+    int y2 = y+h-1;
 
-    // linha superior
-    for(uint8_t xx=x; xx<=x2; xx++){
-        ssd1306_pixel(ssd, xx, y, value);
-    }
-    // linha inferior
-    for(uint8_t xx=x; xx<=x2; xx++){
-        ssd1306_pixel(ssd, xx, y2, value);
-    }
-    // linha esquerda
-    for(uint8_t yy=y; yy<=y2; yy++){
-        ssd1306_pixel(ssd, x, yy, value);
-    }
-    // linha direita
-    for(uint8_t yy=y; yy<=y2; yy++){
-        ssd1306_pixel(ssd, x2, yy, value);
-    }
-
-    if(fill && w>2 && h>2) {
-        for(uint8_t fill_y=y+1; fill_y<y2; fill_y++){
-            for(uint8_t fill_x=x+1; fill_x<x2; fill_x++){
-                ssd1306_pixel(ssd, fill_x, fill_y, value);
-            }
-        }
+    if(fill){
+        blit_rect(ssd, x, y, x2, y2, value);
+        return;
     }
+    blit_rect(ssd, x,  y,  x2, y,  value); // linha superior
+    blit_rect(ssd, x,  y2, x2, y2, value); // linha inferior
+    blit_rect(ssd, x,  y,  x,  y2, value); // linha esquerda
+    blit_rect(ssd, x2, y,  x2, y2, value); // linha direita
 }
 
 /** Bresenham line */
@@ -207,9 +422,7 @@ void ssd1306_hline(ssd1306_t *ssd,
     if(x1<x0){
         uint8_t tmp= x0; x0=x1; x1=tmp;
     }
-    for(uint8_t x=x0; x<=x1; x++){
-        ssd1306_pixel(ssd, x,y,value);
-    }
+    blit_rect(ssd, x0, y, x1, y, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd,
@@ -219,9 +432,7 @@ void ssd1306_vline(ssd1306_t *ssd,
     if(y1<y0){
         uint8_t tmp= y0; y0=y1; y1=tmp;
     }
-    for(uint8_t y=y0; y<=y1;y++){
-        ssd1306_pixel(ssd, x,y,value);
-    }
+    blit_rect(ssd, x, y0, x, y1, value);
 }
 
 /** Desenha caractere 8x8 da fonte */
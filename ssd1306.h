@@ -3,7 +3,8 @@
 
 #include <stdbool.h>
 #include <stdint.h>
-#include "hardware/i2c.h"
+#include <stddef.h>
+#include "hal.h"
 
 // Definições de comando
 typedef enum {
@@ -32,21 +33,45 @@ typedef struct {
   uint8_t pages;        // height/8
   uint8_t address;
   bool    external_vcc;
-  i2c_inst_t *i2c_port;
+  uint8_t i2c_bus;      // 0 => i2c0, 1 => i2c1
 
   uint8_t *ram_buffer;
   size_t   bufsize;
 
   uint8_t  port_buffer[2];
+
+  // Cópia do que o painel mostra agora (width*pages, sem o byte 0x40).
+  // ssd1306_send_data só envia as janelas de cada página que mudaram.
+  uint8_t *shadow;
+  bool     shadow_valid;
+
+  // Envio em segundo plano (hal_i2c_write_async): cada frame é codificado
+  // num dos dois buffers de transmissão. Um pode estar no barramento
+  // enquanto o outro espera a vez, e ram_buffer fica livre para compor o
+  // frame seguinte assim que o envio começa.
+  uint16_t *tx[2];
+  uint16_t  tx_len[2];
+  size_t    tx_cap;               // palavras por buffer
+  volatile uint8_t tx_sending;    // buffer no barramento, ou SSD1306_TX_NONE
+  volatile uint8_t tx_queued;     // buffer esperando o atual, ou SSD1306_TX_NONE
+
+  // Bytes (comandos + dados, sem o endereço) e transações I2C dos frames
+  uint32_t frame_bytes;         // no último ssd1306_flush_begin
+  uint32_t frame_transactions;
+  uint32_t total_bytes;         // acumulado desde ssd1306_init
+  uint32_t total_transactions;
+  uint32_t frames;
 } ssd1306_t;
 
+#define SSD1306_TX_NONE 0xFF
+
 /** Inicializa a estrutura ssd e aloca buffer. */
 void ssd1306_init(ssd1306_t *ssd,
                   uint8_t width,
                   uint8_t height,
                   bool external_vcc,
                   uint8_t address,
-                  i2c_inst_t *i2c);
+                  uint8_t i2c_bus);
 
 /** Envia sequência padrão de config e liga o display. */
 void ssd1306_config(ssd1306_t *ssd);
@@ -54,9 +79,25 @@ void ssd1306_config(ssd1306_t *ssd);
 /** Envia 1 byte de comando. */
 void ssd1306_command(ssd1306_t *ssd, uint8_t cmd);
 
-/** Envia todo o buffer ram_buffer ao display. */
+/** Envia ao display só o que mudou em ram_buffer desde o último envio e espera terminar. */
 void ssd1306_send_data(ssd1306_t *ssd);
 
+/**
+ * Começa a enviar o que mudou em ram_buffer sem bloquear: o frame é
+ * copiado para um buffer de transmissão e ram_buffer já pode ser
+ * alterado. false (nada enviado) se os dois buffers estão ocupados.
+ */
+bool ssd1306_flush_begin(ssd1306_t *ssd);
+
+/** true quando nenhum frame está no barramento nem na fila. */
+bool ssd1306_flush_done(const ssd1306_t *ssd);
+
+/** true se ssd1306_flush_begin aceitaria um frame agora. */
+bool ssd1306_buffer_available(const ssd1306_t *ssd);
+
+/** Força o próximo envio a mandar a tela inteira. */
+void ssd1306_invalidate(ssd1306_t *ssd);
+
 /** Desenha ou apaga 1 pixel. */
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 
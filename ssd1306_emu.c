@@ -0,0 +1,182 @@
+#include "ssd1306_emu.h"
+#include <stdio.h>
+#include <string.h>
+#include "hal_host.h"
+
+static SSD1306Emu *attached = NULL;
+
+void ssd1306_emu_init(SSD1306Emu *e, uint8_t address) {
+    memset(e, 0, sizeof(*e));
+    e->address    = address;
+    e->mode       = 2; // reset: endereçamento por página
+    e->col_end    = SSD1306_EMU_WIDTH - 1;
+    e->page_end   = SSD1306_EMU_PAGES - 1;
+    e->mux        = SSD1306_EMU_HEIGHT;
+    e->contrast   = 0x7F;
+}
+
+/** Bytes de parâmetro que seguem cada comando. */
+static uint8_t params(uint8_t c) {
+    switch(c){
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void run_command(SSD1306Emu *e) {
+    const uint8_t *c = e->cmd;
+    uint8_t op = c[0];
+
+    if(op <= 0x0F){               // coluna inicial (nibble baixo), modo página
+        e->col = (uint8_t)((e->col & 0xF0) | (op & 0x0F));
+    } else if(op <= 0x1F){        // nibble alto
+        e->col = (uint8_t)((e->col & 0x0F) | ((op & 0x0F) << 4));
+    } else if(op >= 0x40 && op <= 0x7F){
+        e->start_line = op & 0x3F;
+    } else if(op >= 0xB0 && op <= 0xB7){
+        e->page = op & 0x07;
+    } else switch(op){
+    case 0x20: e->mode = c[1] & 3; break;
+    case 0x21:
+        e->col_start = c[1] & 0x7F;
+        e->col_end   = c[2] & 0x7F;
+        e->col       = e->col_start;
+        break;
+    case 0x22:
+        e->page_start = c[1] & 7;
+        e->page_end   = c[2] & 7;
+        e->page       = e->page_start;
+        break;
+    case 0x81: e->contrast = c[1]; break;
+    case 0xA0: case 0xA1: e->seg_remap  = op & 1; break;
+    case 0xA4: case 0xA5: e->entire_on  = op & 1; break;
+    case 0xA6: case 0xA7: e->inverse    = op & 1; break;
+    case 0xAE: case 0xAF: e->display_on = op & 1; break;
+    case 0xA8: e->mux = (uint8_t)((c[1] & 0x3F) + 1); break;
+    case 0xC0: case 0xC8: e->com_remap = (op & 0x08) != 0; break;
+    case 0xD3: e->offset = c[1] & 0x3F; break;
+    // só afetam o analógico ou a rolagem: aceitos e ignorados
+    case 0x8D: case 0xD5: case 0xD9: case 0xDA: case 0xDB: case 0xE3:
+    case 0x26: case 0x27: case 0x29: case 0x2A: case 0x2E: case 0x2F: case 0xA3:
+        break;
+    default:
+        e->unknown_commands++;
+        break;
+    }
+}
+
+static void command_byte(SSD1306Emu *e, uint8_t b) {
+    e->frame.command_bytes++;
+    if(e->cmd_len == 0) e->cmd_need = (uint8_t)(1 + params(b));
+    e->cmd[e->cmd_len++] = b;
+    if(e->cmd_len == e->cmd_need){
+        run_command(e);
+        e->cmd_len = 0;
+    }
+}
+
+static void data_byte(SSD1306Emu *e, uint8_t b) {
+    e->frame.data_bytes++;
+    e->gram[e->page & 7][e->col & 0x7F] = b;
+
+    switch(e->mode){
+    case 0: // horizontal: coluna, depois página, dentro das janelas
+        if(e->col >= e->col_end){
+            e->col = e->col_start;
+            e->page = e->page >= e->page_end ? e->page_start : (uint8_t)(e->page + 1);
+        } else {
+            e->col++;
+        }
+        break;
+    case 1: // vertical: página, depois coluna
+        if(e->page >= e->page_end){
+            e->page = e->page_start;
+            e->col = e->col >= e->col_end ? e->col_start : (uint8_t)(e->col + 1);
+        } else {
+            e->page++;
+        }
+        break;
+    default: // página: só a coluna anda, e volta a 0 no fim
+        e->col = (uint8_t)((e->col + 1) & 0x7F);
+        break;
+    }
+}
+
+void ssd1306_emu_write(SSD1306Emu *e, uint8_t addr, const uint8_t *src, size_t len) {
+    if(addr != e->address || len == 0) return;
+    e->frame.transactions++;
+    e->frame.bytes += (uint32_t)len;
+
+    // Co=1: um byte e outro byte de controle; Co=0: o resto é do mesmo tipo
+    size_t i = 0;
+    while(i < len){
+        uint8_t control = src[i++];
+        bool is_data = (control & 0x40) != 0;
+        if(control & 0x80){
+            if(i == len) break;
+            if(is_data) data_byte(e, src[i++]);
+            else        command_byte(e, src[i++]);
+        } else {
+            for(; i < len; i++){
+                if(is_data) data_byte(e, src[i]);
+                else        command_byte(e, src[i]);
+            }
+        }
+    }
+}
+
+static void hook(uint8_t bus, uint8_t addr, const uint8_t *src, size_t len) {
+    (void)bus;
+    if(attached) ssd1306_emu_write(attached, addr, src, len);
+}
+
+void ssd1306_emu_attach(SSD1306Emu *e) {
+    attached = e;
+    hal_host_set_i2c_hook(e ? hook : NULL);
+}
+
+bool ssd1306_emu_pixel(const SSD1306Emu *e, int x, int y) {
+    if(!e->display_on || y >= e->mux) return false;
+    if(e->entire_on) return true;
+
+    // linha do vidro -> saída COM -> linha da GRAM; coluna do vidro -> SEG -> coluna da GRAM
+    int com  = e->com_remap ? e->mux - 1 - y : y;
+    int line = (com + e->offset + e->start_line) & (SSD1306_EMU_HEIGHT - 1);
+    int col  = e->seg_remap ? SSD1306_EMU_WIDTH - 1 - x : x;
+    bool on  = (e->gram[line >> 3][col] >> (line & 7)) & 1;
+    return on != e->inverse;
+}
+
+SSD1306EmuCounters ssd1306_emu_end_frame(SSD1306Emu *e) {
+    SSD1306EmuCounters f = e->frame;
+    e->total.transactions  += f.transactions;
+    e->total.bytes         += f.bytes;
+    e->total.command_bytes += f.command_bytes;
+    e->total.data_bytes    += f.data_bytes;
+    memset(&e->frame, 0, sizeof(e->frame));
+    e->frames++;
+    return f;
+}
+
+bool ssd1306_emu_write_pbm(const SSD1306Emu *e, const char *path) {
+    FILE *f = fopen(path, "wb");
+    if(!f) return false;
+    fprintf(f, "P4\n%d %d\n", SSD1306_EMU_WIDTH, SSD1306_EMU_HEIGHT);
+    for(int y=0; y<SSD1306_EMU_HEIGHT; y++){
+        uint8_t row[SSD1306_EMU_WIDTH / 8] = {0};
+        for(int x=0; x<SSD1306_EMU_WIDTH; x++){
+            if(ssd1306_emu_pixel(e, x, y)) row[x >> 3] |= (uint8_t)(0x80u >> (x & 7));
+        }
+        fwrite(row, 1, sizeof(row), f);
+    }
+    return fclose(f) == 0;
+}
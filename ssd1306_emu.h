@@ -0,0 +1,80 @@
+#ifndef SSD1306_EMU_H
+#define SSD1306_EMU_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Emulador (host) do painel SSD1306 128x64 no barramento I2C: interpreta
+ * os bytes que ssd1306.c manda por hal_i2c_write (bytes de controle
+ * 0x80/0x00/0x40/0xC0, comandos com parâmetros, modos de endereçamento
+ * horizontal/vertical/página, janelas de coluna e página, remap de
+ * segmento, direção do COM, linha inicial, offset, inversão) e mantém a
+ * GRAM. A imagem "no vidro" sai em PBM.
+ *
+ * Também conta transações e bytes (comando/dado) por frame, para medir o
+ * custo de barramento das otimizações do driver sem hardware.
+ */
+
+#define SSD1306_EMU_WIDTH  128
+#define SSD1306_EMU_HEIGHT 64
+#define SSD1306_EMU_PAGES  (SSD1306_EMU_HEIGHT / 8)
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;         // tudo depois do endereço, bytes de controle inclusos
+    uint32_t command_bytes;
+    uint32_t data_bytes;
+} SSD1306EmuCounters;
+
+typedef struct {
+    uint8_t address;
+    uint8_t gram[SSD1306_EMU_PAGES][SSD1306_EMU_WIDTH];
+
+    // estado de endereçamento
+    uint8_t mode;              // 0 horizontal, 1 vertical, 2 página
+    uint8_t col_start, col_end;
+    uint8_t page_start, page_end;
+    uint8_t col, page;         // ponteiro de escrita
+
+    // estado do painel
+    bool    display_on;
+    bool    entire_on;
+    bool    inverse;
+    bool    seg_remap;
+    bool    com_remap;
+    uint8_t start_line;
+    uint8_t offset;
+    uint8_t mux;               // linhas ativas (MUX ratio + 1)
+    uint8_t contrast;
+
+    // comando com parâmetros em andamento (pode atravessar transações)
+    uint8_t cmd[8];
+    uint8_t cmd_len, cmd_need;
+
+    SSD1306EmuCounters frame;  // desde o último ssd1306_emu_end_frame
+    SSD1306EmuCounters total;
+    uint32_t frames;
+    uint32_t unknown_commands;
+} SSD1306Emu;
+
+/** Estado do painel depois do reset, respondendo em 'address'. */
+void ssd1306_emu_init(SSD1306Emu *e, uint8_t address);
+
+/** Uma transação I2C (mesma assinatura do gancho de hal_host.h). */
+void ssd1306_emu_write(SSD1306Emu *e, uint8_t addr, const uint8_t *src, size_t len);
+
+/** Liga 'e' ao gancho de I2C de hal_host (um emulador por vez; NULL desliga). */
+void ssd1306_emu_attach(SSD1306Emu *e);
+
+/** Pixel (x, y) como aparece no vidro, já com remap, offset e inversão. */
+bool ssd1306_emu_pixel(const SSD1306Emu *e, int x, int y);
+
+/** Fecha o frame: devolve os contadores dele e começa outro. */
+SSD1306EmuCounters ssd1306_emu_end_frame(SSD1306Emu *e);
+
+/** Grava a imagem do vidro em PBM binário (P4); false em erro de E/S. */
+bool ssd1306_emu_write_pbm(const SSD1306Emu *e, const char *path);
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * Testes do auto_repeat e da histerese dos eixos (input_events) com
+ * sequências sintéticas de instantes: DAS, espaçamento do ARR, rajadas
+ * de recuperação limitadas por max_burst, troca para arr_hold_us e
+ * independência da taxa de frames. Os eixos rodam sobre o hal_host, com
+ * o ADC e o relógio simulados.
+ */
+#include <stdio.h>
+#include "auto_repeat.h"
+#include "input_events.h"
+#include "hal_host.h"
+
+static int failures;
+
+#define CHECK(cond) do {                                                \
+    if(!(cond)){                                                        \
+        printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond);         \
+        failures++;                                                     \
+    }                                                                   \
+} while(0)
+
+static const AutoRepeatConfig SHIFT = {
+    .das_us = 133000, .arr_us = 33000, .max_burst = 10,
+};
+
+static void test_das(void) {
+    AutoRepeat ar;
+    auto_repeat_init(&ar, &SHIFT);
+    CHECK(auto_repeat_update(&ar, 1000, true) == 1);           // disparo do aperto
+    CHECK(auto_repeat_update(&ar, 1000 + 132999, true) == 0);  // ainda no DAS
+    CHECK(auto_repeat_update(&ar, 1000 + 133000, true) == 1);  // primeira repetição
+    CHECK(auto_repeat_next_us(&ar) == 1000 + 133000 + 33000);
+}
+
+static void test_arr_spacing(void) {
+    AutoRepeat ar;
+    auto_repeat_init(&ar, &SHIFT);
+    auto_repeat_update(&ar, 0, true);
+    auto_repeat_update(&ar, 133000, true);
+    // uma repetição a cada 33 ms, nem antes nem depois
+    for(int k=1; k<=10; k++){
+        uint64_t t = 133000 + (uint64_t)k * 33000;
+        CHECK(auto_repeat_update(&ar, t - 1, true) == 0);
+        CHECK(auto_repeat_update(&ar, t, true) == 1);
+    }
+    // soltou: nada vence e o próximo aperto dispara na hora
+    CHECK(auto_repeat_update(&ar, 470000, false) == 0);
+    CHECK(auto_repeat_next_us(&ar) == UINT64_MAX);
+    CHECK(auto_repeat_update(&ar, 900000, false) == 0);
+    CHECK(auto_repeat_update(&ar, 900001, true) == 1);
+}
+
+static void test_catch_up_burst(void) {
+    AutoRepeatConfig cfg = SHIFT;
+    cfg.max_burst = 3;
+    AutoRepeat ar;
+    auto_repeat_init(&ar, &cfg);
+    auto_repeat_update(&ar, 0, true);
+    // frame atrasado: 5 repetições vencidas (133, 166, 199, 232, 265 ms)
+    CHECK(auto_repeat_update(&ar, 270000, true) == 3);
+    // o excesso é descartado e a cadência recomeça do instante da chamada
+    CHECK(auto_repeat_next_us(&ar) == 270000 + 33000);
+    CHECK(auto_repeat_update(&ar, 302999, true) == 0);
+    CHECK(auto_repeat_update(&ar, 303000, true) == 1);
+
+    // dentro do limite, tudo o que venceu sai de uma vez
+    auto_repeat_init(&ar, &SHIFT);
+    auto_repeat_update(&ar, 0, true);
+    CHECK(auto_repeat_update(&ar, 270000, true) == 5);
+    CHECK(auto_repeat_next_us(&ar) == 298000);
+}
+
+static void test_hold_rate(void) {
+    const AutoRepeatConfig button = {
+        .das_us = 200000, .arr_us = 200000, .hold_us = 1000000, .arr_hold_us = 66000, .max_burst = 1,
+    };
+    AutoRepeat ar;
+    auto_repeat_init(&ar, &button);
+    auto_repeat_update(&ar, 0, true);
+    uint32_t fired = 0;
+    uint64_t last = 0;
+    for(uint64_t t=1000; t<=1000000; t+=1000) fired += auto_repeat_update(&ar, t, true);
+    CHECK(fired == 5); // 200, 400, 600, 800 e 1000 ms
+    // depois de hold_us o intervalo é arr_hold_us
+    for(uint64_t t=1000001; t<=1200000; t++){
+        if(auto_repeat_update(&ar, t, true)){
+            if(last) CHECK(t - last == 66000);
+            last = t;
+        }
+    }
+    CHECK(last == 1198000);
+}
+
+// Mesmos disparos em 1 s com frames de 10 ms ou de 33 ms
+static uint32_t run_frames(uint32_t frame_us) {
+    AutoRepeat ar;
+    auto_repeat_init(&ar, &SHIFT);
+    uint32_t fired = auto_repeat_update(&ar, 0, true);
+    for(uint64_t t=frame_us; t<=1000000; t+=frame_us) fired += auto_repeat_update(&ar, t, true);
+    return fired + auto_repeat_update(&ar, 1000000, true);
+}
+
+static void test_frame_rate_independent(void) {
+    uint32_t expect = 1 + 1 + (1000000 - 133000) / 33000; // aperto + DAS + ARRs
+    CHECK(run_frames(10000) == expect);
+    CHECK(run_frames(33000) == expect);
+    CHECK(run_frames(50000) == expect);
+}
+
+// Avança e devolve a última zona publicada do eixo X (ou 'none'); 50 ms
+// cobrem a olhada lenta de quando tudo está parado mais a janela do ADC
+static int axis_after(uint16_t adc, int none) {
+    hal_host_set_adc(1, adc);
+    hal_host_advance_us(50000);
+    InputEvent ev;
+    int z = none;
+    while(input_events_pop(&ev)){
+        if(ev.source == INPUT_AXIS_X) z = ev.value;
+    }
+    return z;
+}
+
+static void test_axis_hysteresis(void) {
+    hal_init();
+    for(uint8_t pin=0; pin<HAL_HOST_NUM_PINS; pin++) hal_gpio_init_input(pin, true);
+    InputConfig cfg = {
+        .button_pins = { 5, 6, 22 },
+        .axis_inputs = { 1, 0 },
+    };
+    input_events_init(&cfg);
+
+    const int NONE = 99;
+    CHECK(axis_after(2048, NONE) == NONE);
+    CHECK(axis_after(INPUT_AXIS_LOW - 1, NONE) == -1);                   // entra em -1
+    CHECK(axis_after(INPUT_AXIS_LOW + INPUT_AXIS_HYST - 1, NONE) == NONE); // folga: fica
+    CHECK(axis_after(INPUT_AXIS_LOW + INPUT_AXIS_HYST, NONE) == 0);        // sai
+    CHECK(axis_after(INPUT_AXIS_LOW + 1, NONE) == NONE);                   // não volta sem passar do limiar
+    CHECK(axis_after(INPUT_AXIS_HIGH + 1, NONE) == 1);
+    CHECK(axis_after(INPUT_AXIS_HIGH - INPUT_AXIS_HYST + 1, NONE) == NONE);
+    CHECK(axis_after(INPUT_AXIS_HIGH - INPUT_AXIS_HYST, NONE) == 0);
+    CHECK(axis_after(INPUT_AXIS_HIGH, NONE) == NONE);
+    CHECK(input_events_dropped() == 0);
+}
+
+int main(void) {
+    test_das();
+    test_arr_spacing();
+    test_catch_up_burst();
+    test_hold_rate();
+    test_frame_rate_independent();
+    test_axis_hysteresis();
+    if(failures){
+        printf("%d falha(s)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
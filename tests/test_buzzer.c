@@ -0,0 +1,138 @@
+/**
+ * Teste do sequenciador de buzzer.c sobre o PWM e o alarme simulados do
+ * hal_host: notas enfileiradas nos dois canais, relógio avançado e cada
+ * mudança de nível/divisor conferida no instante da fronteira da nota,
+ * com um canal sem interferir no outro.
+ */
+#include <math.h>
+#include <stdio.h>
+#include "buzzer.h"
+#include "hal_host.h"
+
+// Pinos de buzzer.c
+#define PIN_A 21
+#define PIN_B 10
+#define DUTY  2048
+
+static int failures;
+
+#define CHECK(cond) do {                                                \
+    if(!(cond)){                                                        \
+        printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond);         \
+        failures++;                                                     \
+    }                                                                   \
+} while(0)
+
+// Mudanças do som de um pino: nível novo, ou divisor novo com o som ligado
+typedef struct {
+    uint64_t time_us;
+    uint16_t level;
+    float    clkdiv;
+} Change;
+
+#define MAX_CHANGES 32
+
+typedef struct {
+    Change   log[MAX_CHANGES];
+    int      n;
+    uint16_t level;
+    float    clkdiv;
+} PinLog;
+
+static PinLog pin_a, pin_b;
+
+static void hook(uint8_t pin, uint64_t time_us, uint16_t level, float clkdiv) {
+    PinLog *p = pin == PIN_A ? &pin_a : pin == PIN_B ? &pin_b : NULL;
+    if(!p) return;
+    bool changed = level != p->level || (level && clkdiv != p->clkdiv);
+    p->level  = level;
+    p->clkdiv = clkdiv;
+    if(changed && p->n < MAX_CHANGES) p->log[p->n++] = (Change){ time_us, level, clkdiv };
+}
+
+static float divider(uint16_t freq) {
+    return (float)hal_sys_clock_hz() / (4096.0f * freq);
+}
+
+// A i-ésima mudança do pino: instante relativo a t0, nível e (se soa) a frequência
+static void expect(const PinLog *p, int i, uint64_t t0, uint32_t at_ms, uint16_t freq) {
+    if(i >= p->n){
+        printf("FALHA: mudança %d não aconteceu (esperada em %u ms)\n", i, (unsigned)at_ms);
+        failures++;
+        return;
+    }
+    const Change *c = &p->log[i];
+    CHECK(c->time_us == t0 + (uint64_t)at_ms * 1000);
+    CHECK(c->level == (freq ? DUTY : 0));
+    if(freq) CHECK(fabsf(c->clkdiv - divider(freq)) < 1e-3f);
+}
+
+int main(void) {
+    hal_init();
+    buzzer_a_init();
+    buzzer_b_init();
+    hal_host_set_pwm_hook(hook);
+
+    uint64_t t0 = hal_time_us();
+
+    // A: 440 Hz, pausa, 880 Hz, enfileirados de uma vez
+    static const buzzer_note_t seq_a[] = { { 440, 100 }, { 0, 50 }, { 880, 30 } };
+    CHECK(buzzer_enqueue_sequence(BUZZER_A, seq_a, 3) == 3);
+    CHECK(buzzer_busy(BUZZER_A) && !buzzer_busy(BUZZER_B));
+
+    // B entra 20 ms depois, no meio da primeira nota de A
+    hal_host_advance_us(20000);
+    CHECK(buzzer_enqueue(BUZZER_B, 1000, 70));
+    CHECK(buzzer_enqueue(BUZZER_B, 500, 40));
+
+    hal_host_advance_us(280000);
+    CHECK(!buzzer_busy(BUZZER_A) && !buzzer_busy(BUZZER_B));
+
+    CHECK(pin_a.n == 4);
+    expect(&pin_a, 0, t0, 0, 440);
+    expect(&pin_a, 1, t0, 100, 0);
+    expect(&pin_a, 2, t0, 150, 880);
+    expect(&pin_a, 3, t0, 180, 0);
+
+    CHECK(pin_b.n == 3);
+    expect(&pin_b, 0, t0, 20, 1000);
+    expect(&pin_b, 1, t0, 90, 500);
+    expect(&pin_b, 2, t0, 130, 0);
+
+    // buzzer_play interrompe só o próprio canal
+    uint64_t t1 = hal_time_us();
+    CHECK(buzzer_enqueue(BUZZER_A, 300, 100));
+    hal_host_advance_us(10000);
+    buzzer_play(BUZZER_B, 600, 20);
+    buzzer_play(BUZZER_B, 700, 20);   // troca a nota de B na hora
+    hal_host_advance_us(200000);
+    CHECK(pin_a.n == 6);
+    expect(&pin_a, 4, t1, 0, 300);
+    expect(&pin_a, 5, t1, 100, 0);
+    CHECK(pin_b.n == 6);
+    expect(&pin_b, 3, t1, 10, 600);
+    expect(&pin_b, 4, t1, 10, 700);
+    expect(&pin_b, 5, t1, 30, 0);
+
+    // buzzer_stop silencia e descarta a fila só do canal parado
+    uint64_t t2 = hal_time_us();
+    CHECK(buzzer_enqueue(BUZZER_A, 400, 50));
+    CHECK(buzzer_enqueue(BUZZER_A, 450, 50));
+    CHECK(buzzer_enqueue(BUZZER_B, 800, 80));
+    hal_host_advance_us(20000);
+    buzzer_stop(BUZZER_A);
+    hal_host_advance_us(200000);
+    CHECK(pin_a.n == 8);
+    expect(&pin_a, 6, t2, 0, 400);
+    expect(&pin_a, 7, t2, 20, 0);
+    CHECK(pin_b.n == 8);
+    expect(&pin_b, 6, t2, 0, 800);
+    expect(&pin_b, 7, t2, 80, 0);
+
+    if(failures){
+        printf("%d falha(s)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
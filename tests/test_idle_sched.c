@@ -0,0 +1,148 @@
+/**
+ * Testes da espera entre frames (idle_sched) e dos prazos do frame_clock
+ * sobre o relógio simulado do hal_host: vence o prazo mais cedo entre
+ * FRAME/ANIM/GRAVITY/REPEAT, um prazo já passado volta na hora, e o
+ * despertar da gravidade cai no passo fixo em que ela vence, sem dormir
+ * um passo além.
+ */
+#include <stdio.h>
+#include "idle_sched.h"
+#include "frame_clock.h"
+#include "hal_host.h"
+
+#define STEP_US   10000
+#define PERIOD_US 33000
+
+static int failures;
+
+#define CHECK(cond) do {                                                \
+    if(!(cond)){                                                        \
+        printf("FALHA %s:%d: %s\n", __FILE__, __LINE__, #cond);         \
+        failures++;                                                     \
+    }                                                                   \
+} while(0)
+
+static bool input_flag;
+
+static bool woken(void) {
+    return input_flag;
+}
+
+static const IdleWake SOURCES[] = {
+    IDLE_WAKE_FRAME, IDLE_WAKE_ANIM, IDLE_WAKE_GRAVITY, IDLE_WAKE_REPEAT,
+};
+#define NUM_SOURCES 4
+
+// Cada fonte, por sua vez, com o prazo mais cedo; as outras mais tarde
+static void test_earliest(void) {
+    IdleSched s;
+    idle_sched_init(&s, hal_time_us());
+    for(int k=0; k<NUM_SOURCES; k++){
+        uint64_t now = hal_time_us();
+        for(int i=0; i<NUM_SOURCES; i++){
+            uint64_t at = now + (i == k ? 7000 : 20000 + 1000u * (uint64_t)i);
+            idle_sched_at(&s, SOURCES[i], at);
+        }
+        // um pedido mais tarde da mesma fonte não adia o prazo dela
+        idle_sched_at(&s, SOURCES[k], now + 90000);
+
+        IdleWake src;
+        CHECK(idle_sched_deadline(&s, now, &src) == now + 7000);
+        CHECK(src == SOURCES[k]);
+        CHECK(idle_sched_sleep(&s, now, woken) == SOURCES[k]);
+        CHECK(hal_time_us() == now + 7000);
+    }
+    // os prazos valem para um frame só: sem pedidos, dorme até o limite
+    uint64_t now = hal_time_us();
+    CHECK(idle_sched_sleep(&s, now, woken) == IDLE_WAKE_LIMIT);
+    CHECK(hal_time_us() == now + IDLE_MAX_SLEEP_US);
+}
+
+static void test_past_deadline(void) {
+    IdleSched s;
+    idle_sched_init(&s, hal_time_us());
+    uint64_t now = hal_time_us();
+    idle_sched_at(&s, IDLE_WAKE_GRAVITY, now - 3000);
+    idle_sched_at(&s, IDLE_WAKE_FRAME, now + PERIOD_US);
+    CHECK(idle_sched_sleep(&s, now, woken) == IDLE_WAKE_GRAVITY);
+    CHECK(hal_time_us() == now);
+
+    // entrada pendente: volta na hora mesmo com prazo no futuro
+    idle_sched_at(&s, IDLE_WAKE_FRAME, now + PERIOD_US);
+    input_flag = true;
+    CHECK(idle_sched_sleep(&s, now, woken) == IDLE_WAKE_INPUT);
+    CHECK(hal_time_us() == now);
+    input_flag = false;
+}
+
+// Laço com só a gravidade como prazo, como o principal sem entradas: o
+// despertar é o instante do passo em que ela vence, nem um passo depois
+static void test_gravity_step(void) {
+    const uint32_t interval_ms = 173; // < IDLE_MAX_SLEEP_US, fora do passo
+    IdleSched s;
+    FrameClock fc;
+    hal_host_advance_us(1234); // início fora do alinhamento do passo
+    idle_sched_init(&s, hal_time_us());
+    frame_clock_init(&fc, STEP_US, PERIOD_US, hal_time_us());
+
+    uint64_t sim_us = 0;     // simulado até agora
+    uint64_t next_ms = interval_ms;
+    for(int frame=0; frame<40; frame++){
+        uint64_t start = hal_time_us();
+        uint32_t steps = frame_clock_begin(&fc, start);
+        sim_us += (uint64_t)steps * STEP_US;
+        uint64_t due_us = next_ms * 1000;
+        if(frame > 0){
+            // acordou pela gravidade: o passo dela já está simulado, e só ele
+            CHECK(sim_us >= due_us);
+            CHECK(sim_us < due_us + STEP_US);
+            next_ms += interval_ms;
+        }
+
+        uint32_t idle_us = frame_clock_end(&fc, hal_time_us());
+        CHECK(idle_us == PERIOD_US); // o frame não gasta tempo simulado
+        uint64_t now = hal_time_us();
+        uint64_t gravity_us = next_ms * 1000 - sim_us;
+        idle_sched_at(&s, IDLE_WAKE_GRAVITY, frame_clock_sim_deadline(&fc, gravity_us));
+        CHECK(idle_sched_sleep(&s, now, woken) == IDLE_WAKE_GRAVITY);
+        frame_clock_slept_until(&fc, hal_time_us());
+    }
+    // dormir além do período não conta como atraso
+    CHECK(frame_clock_stats(&fc)->dropped_us == 0);
+}
+
+// Pedido de frame: acorda no fim do período, e a simulação anda o período
+static void test_frame_period(void) {
+    IdleSched s;
+    FrameClock fc;
+    idle_sched_init(&s, hal_time_us());
+    frame_clock_init(&fc, STEP_US, PERIOD_US, hal_time_us());
+    uint64_t simulated = 0;
+    for(int frame=0; frame<30; frame++){
+        uint64_t start = hal_time_us();
+        simulated += (uint64_t)frame_clock_begin(&fc, start) * STEP_US;
+        hal_host_advance_us(4000); // trabalho do frame
+        uint32_t idle_us = frame_clock_end(&fc, hal_time_us());
+        uint64_t now = hal_time_us();
+        idle_sched_at(&s, IDLE_WAKE_FRAME, now + idle_us);
+        CHECK(idle_sched_sleep(&s, now, woken) == IDLE_WAKE_FRAME);
+        CHECK(hal_time_us() == start + PERIOD_US);
+        frame_clock_slept_until(&fc, hal_time_us());
+    }
+    // 29 períodos completos até o início do último frame, menos o resto
+    CHECK(simulated == (29u * PERIOD_US) / STEP_US * STEP_US);
+}
+
+int main(void) {
+    hal_init();
+    test_earliest();
+    test_past_deadline();
+    test_gravity_step();
+    test_frame_period();
+    if(failures){
+        printf("%d falha(s)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -1,283 +1,273 @@
 #include "tetris.h"
-#include <string.h>  // memset
-#include <stdlib.h>  // rand
 #include <stdio.h>
-#include <math.h>
+#include <string.h>
+#include <stddef.h>
 #include <stdbool.h>
-#include "buzzer.h"
-
-// Se você precisa usar o driver ssd1306, inclua:
-#include "ssd1306.h"
-
-#define buzzer_play_tone(freq, dur) do { \
-    buzzer_a_play_tone((freq), (dur));  \
-    buzzer_b_play_tone((freq), (dur));  \
-} while(0)
-
-#define buzzer_beep() do { \
-    buzzer_a_beep();         \
-    buzzer_b_beep();         \
-} while(0)
-
-
-// Precisamos de uma referência global ou 'extern' para o display:
-extern ssd1306_t g_oled_dev; 
-
-static int board[TETRIS_WIDTH][TETRIS_HEIGHT];
-static bool game_over = false;
-static uint32_t score = 0;
-
-static uint32_t gravity_interval = 800;
-static uint32_t gravity_timer    = 0;
-
-typedef struct {
-    const unsigned int *shape;
-    int x, y;
-    int rotation; // 0..3
-    int color_id; // 1..7
-} TetrisPiece;
-
-static TetrisPiece current;
-static TetrisPiece next;
-
-// Shapes
-static unsigned int I_SHAPE[] = {0x0F00,0x2222,0x00F0,0x4444};
-static unsigned int O_SHAPE[] = {0xCC00,0xCC00,0xCC00,0xCC00};
-static unsigned int T_SHAPE[] = {0x0E40,0x4C40,0x4E00,0x4640};
-static unsigned int S_SHAPE[] = {0x06C0,0x8C40,0x6C00,0x4620};
-static unsigned int Z_SHAPE[] = {0x0C60,0x4C80,0xC600,0x2640};
-static unsigned int J_SHAPE[] = {0x44C0,0x8E00,0x6440,0x0E20};
-static unsigned int L_SHAPE[] = {0x4460,0x0E80,0xC440,0x2E00};
-
-static const unsigned int *ALL_SHAPES[] = {
-    I_SHAPE, O_SHAPE, T_SHAPE, S_SHAPE, Z_SHAPE, J_SHAPE, L_SHAPE
-};
-static int ALL_COLORS[] = {1,2,3,4,5,6,7};
-
-static void new_game(void);
-static void spawn_piece(void);
-static bool check_collision(const TetrisPiece *p, int nx, int ny, int nrot);
-static void lock_piece(void);
-static void remove_lines(void);
-
-void tetris_init(void) {
-    srand(1234); // ou algo mais aleatório
-    new_game();
+
+static void new_game(TetrisGame *g);
+static void spawn_piece(TetrisGame *g);
+static bool check_collision(const TetrisGame *g, const TetrisPiece *p, int nx, int ny, int nrot);
+static TetrisRowSpan lock_piece(TetrisGame *g);
+static void remove_lines(TetrisGame *g, TetrisRowSpan touched);
+static void settle(TetrisGame *g);
+
+// Qualquer mudança que aparece na tela passa por aqui
+static inline void mark_changed(TetrisGame *g) {
+    g->generation++;
 }
 
-static void new_game(void) {
-    memset(board, 0, sizeof(board));
-    game_over = false;
-    score     = 0;
-    gravity_interval = 800;
-    gravity_timer    = 0;
-
-    // inicia 'next'
-    int idx = rand() % 7;
-    next.shape    = ALL_SHAPES[idx];
-    next.x        = 3;
-    next.y        = 0;
-    next.rotation = 0;
-    next.color_id = ALL_COLORS[idx];
-
-    spawn_piece();
+void tetris_init(TetrisGame *g, uint32_t seed, PieceRandomizer mode) {
+    piece_queue_init(&g->queue, seed, mode);
+    new_game(g);
 }
 
-static void spawn_piece(void) {
-    current = next;
-    int idx = rand() % 7;
-    next.shape    = ALL_SHAPES[idx];
-    next.x        = 3;
-    next.y        = 0;
-    next.rotation = 0;
-    next.color_id = ALL_COLORS[idx];
-
-    if(check_collision(&current, current.x, current.y, current.rotation)) {
-        game_over = true;
-    }
+void tetris_set_20g(TetrisGame *g, bool on) {
+    g->gravity_20g      = on;
+    g->gravity_interval = on ? TETRIS_LOCK_DELAY_20G_MS : TETRIS_GRAVITY_START_MS;
+    g->gravity_timer    = 0;
+    settle(g);
+    mark_changed(g);
 }
 
-static bool check_collision(const TetrisPiece *p, int nx, int ny, int nrot) {
-    unsigned int blocks = p->shape[nrot];
-    unsigned int bit = 0x8000;
-    int row=0, col=0;
-
-    for(; bit>0; bit>>=1) {
-        if(blocks & bit) {
-            int bx = nx + col;
-            int by = ny + row;
-            if(bx<0 || bx>=TETRIS_WIDTH || by<0|| by>=TETRIS_HEIGHT) {
-                return true;
-            }
-            if(board[bx][by] != 0) {
-                return true;
-            }
-        }
-        col++;
-        if(col==4) { col=0; row++; }
+int tetris_peek(const TetrisGame *g, int i) {
+    return piece_queue_peek(&g->queue, i);
+}
+
+static void set_piece(TetrisPiece *p, int idx) {
+    p->type     = (int8_t)idx;
+    p->x        = 3;
+    p->y        = 0;
+    p->rotation = 0;
+    p->color_id = (uint8_t)(idx + 1);
+}
+
+static void new_game(TetrisGame *g) {
+    tetris_board_clear(&g->board);
+    g->game_over = false;
+    g->score     = 0;
+    g->pieces    = 0;
+    g->lines     = 0;
+    g->events    = 0;
+    g->generation = 0;
+    g->cleared_rows = 0;
+    g->gravity_interval = TETRIS_GRAVITY_START_MS;
+    g->gravity_timer    = 0;
+    g->gravity_20g      = false;
+
+    spawn_piece(g);
+}
+
+// 'next' espelha a cabeça da fila, para quem só precisa de uma prévia
+static void spawn_piece(TetrisGame *g) {
+    set_piece(&g->current, piece_queue_pop(&g->queue));
+    set_piece(&g->next, piece_queue_peek(&g->queue, 0));
+    g->pieces++;
+    mark_changed(g);
+
+    if(check_collision(g, &g->current, g->current.x, g->current.y, g->current.rotation)) {
+        g->game_over = true;
+        g->events |= TETRIS_EVENT_GAME_OVER;
+        return;
+    }
+    if(g->gravity_20g){
+        // o atraso de trava vale inteiro para cada peça
+        g->gravity_timer = 0;
+        settle(g);
     }
-    return false;
 }
 
-void tetris_update(uint32_t dt_ms) {
-    if(game_over) return;
+// Em 20G a peça fica sempre pousada: depois de entrar, mover ou girar
+static void settle(TetrisGame *g) {
+    if(!g->gravity_20g) return;
+    const TetrisPiece *p = &g->current;
+    g->current.y = (int8_t)tetris_board_drop_y(&g->board, p->type, p->rotation, p->x, p->y);
+}
+
+static bool check_collision(const TetrisGame *g, const TetrisPiece *p, int nx, int ny, int nrot) {
+    return tetris_board_collides(&g->board, p->type, nrot, nx, ny);
+}
+
+void tetris_update(TetrisGame *g, uint32_t dt_ms) {
+    if(g->game_over) return;
 
-    gravity_timer += dt_ms;
-    if(gravity_timer >= gravity_interval) {
-        gravity_timer = 0;
+    // O resto fica no timer: a queda não atrasa com dt irregulares, e um
+    // dt grande aplica todas as quedas vencidas.
+    g->gravity_timer += dt_ms;
+    while(!g->game_over && g->gravity_timer >= g->gravity_interval) {
+        g->gravity_timer -= g->gravity_interval;
         // move down
-        int ny = current.y + 1;
-        if(check_collision(&current, current.x, ny, current.rotation)) {
-            lock_piece();
-            remove_lines();
-            spawn_piece();
+        int ny = g->current.y + 1;
+        if(check_collision(g, &g->current, g->current.x, ny, g->current.rotation)) {
+            remove_lines(g, lock_piece(g));
+            spawn_piece(g);
         } else {
-            current.y = ny;
+            g->current.y = (int8_t)ny;
+            mark_changed(g);
         }
     }
 }
 
-static void lock_piece(void) {
-    unsigned int blocks = current.shape[current.rotation];
-    unsigned int bit=0x8000;
-    int row=0,col=0;
-    for(; bit>0; bit>>=1) {
-        if(blocks & bit) {
-            int bx = current.x + col;
-            int by = current.y + row;
-            board[bx][by] = current.color_id;
-        }
-        col++;
-        if(col==4){ col=0; row++; }
-    }
-    buzzer_a_play_tone(300, 50);
-    buzzer_b_play_tone(300, 50);
-
+static TetrisRowSpan lock_piece(TetrisGame *g) {
+    TetrisRowSpan touched = tetris_board_lock(&g->board, g->current.type, g->current.rotation,
+                                              g->current.x, g->current.y, g->current.color_id);
+    g->events |= TETRIS_EVENT_LOCK;
+    return touched;
 }
 
-static void remove_lines(void) {
-    int lines_cleared=0;
-    for(int y=0; y<TETRIS_HEIGHT; y++){
-        bool full=true;
-        for(int x=0; x< TETRIS_WIDTH;x++){
-            if(board[x][y]==0){
-                full=false;
-                break;
-            }
-        }
-        if(full){
-            lines_cleared++;
-            // shift everything down
-            for(int yy=y; yy>0;yy--){
-                for(int xx=0;xx<TETRIS_WIDTH;xx++){
-                    board[xx][yy]= board[xx][yy-1];
-                }
-            }
-            for(int xx=0;xx<TETRIS_WIDTH;xx++){
-                board[xx][0]=0;
-            }
-        }
-    }
+static void remove_lines(TetrisGame *g, TetrisRowSpan touched) {
+    // quais linhas saem, para a animação reconstruir o tabuleiro de antes
+    g->cleared_rows = tetris_board_remove_lines(&g->board, touched);
+    int lines_cleared = __builtin_popcount(g->cleared_rows);
     if(lines_cleared>0){
-        score += (100U * (int)pow(2,(lines_cleared-1)));
-        if(gravity_interval>100){
-            gravity_interval-= (20*lines_cleared);
+        g->score += 100U << (lines_cleared-1);
+        g->lines += (uint32_t)lines_cleared;
+        if(!g->gravity_20g && g->gravity_interval>TETRIS_GRAVITY_FLOOR_MS){
+            g->gravity_interval-= (20*lines_cleared);
         }
-        // Toca um tom mais longo ao completar linha(s)
-        buzzer_play_tone(600, 150);
+        g->events |= TETRIS_EVENT_LINES;
     }
 }
 
-void tetris_move_left(void) {
-    if(game_over)return;
-    int nx= current.x-1;
-    if(!check_collision(&current,nx,current.y,current.rotation)){
-        current.x= nx;
-
-        // Som ao mover para a esquerda
-        buzzer_a_beep();
-        buzzer_b_beep();
-
+void tetris_move_left(TetrisGame *g) {
+    if(g->game_over)return;
+    int nx= g->current.x-1;
+    if(!check_collision(g,&g->current,nx,g->current.y,g->current.rotation)){
+        g->current.x= (int8_t)nx;
+        g->events |= TETRIS_EVENT_MOVE;
+        mark_changed(g);
+        settle(g);
     }
 }
-void tetris_move_right(void){
-    if(game_over)return;
-    int nx= current.x+1;
-    if(!check_collision(&current,nx,current.y,current.rotation)){
-        current.x=nx;
-
-        // Som ao mover para a esquerda
-        buzzer_a_beep();
-        buzzer_b_beep();
-
+void tetris_move_right(TetrisGame *g){
+    if(g->game_over)return;
+    int nx= g->current.x+1;
+    if(!check_collision(g,&g->current,nx,g->current.y,g->current.rotation)){
+        g->current.x= (int8_t)nx;
+        g->events |= TETRIS_EVENT_MOVE;
+        mark_changed(g);
+        settle(g);
     }
 }
 
-void tetris_rotate_clockwise(void) {
-    if(game_over)return;
-    int nr= (current.rotation+1)%4;
-    if(!check_collision(&current,current.x,current.y,nr)){
-        current.rotation= nr;
-        buzzer_beep(); // Som ao girar (horário)
+void tetris_rotate_clockwise(TetrisGame *g) {
+    if(g->game_over)return;
+    int nr= (g->current.rotation+1)%4;
+    if(!check_collision(g,&g->current,g->current.x,g->current.y,nr)){
+        g->current.rotation= (uint8_t)nr;
+        g->events |= TETRIS_EVENT_ROTATE;
+        mark_changed(g);
+        settle(g);
     }
 }
 
-void tetris_rotate_counter(void){
-    if(game_over)return;
-    int nr= (current.rotation+3)%4;
-    if(!check_collision(&current,current.x,current.y,nr)){
-        current.rotation= nr;
-        buzzer_beep(); // Som ao girar (horário)
+void tetris_rotate_counter(TetrisGame *g){
+    if(g->game_over)return;
+    int nr= (g->current.rotation+3)%4;
+    if(!check_collision(g,&g->current,g->current.x,g->current.y,nr)){
+        g->current.rotation= (uint8_t)nr;
+        g->events |= TETRIS_EVENT_ROTATE;
+        mark_changed(g);
+        settle(g);
     }
 }
 
-void tetris_soft_drop(void){
-    if(game_over)return;
-    int ny= current.y+1;
-    if(check_collision(&current,current.x,ny,current.rotation)){
-        lock_piece();
-        remove_lines();
-        spawn_piece();
+void tetris_soft_drop(TetrisGame *g){
+    if(g->game_over)return;
+    int ny= g->current.y+1;
+    if(check_collision(g,&g->current,g->current.x,ny,g->current.rotation)){
+        remove_lines(g, lock_piece(g));
+        spawn_piece(g);
     } else {
-        current.y=ny;
+        g->current.y= (int8_t)ny;
+        mark_changed(g);
     }
 }
 
-void tetris_hard_drop(void){
-    if(game_over)return;
-    while(!check_collision(&current,current.x,current.y+1,current.rotation)){
-        current.y++;
+void tetris_hard_drop(TetrisGame *g){
+    if(g->game_over)return;
+    const TetrisPiece *p= &g->current;
+    g->current.y= (int8_t)tetris_board_drop_y(&g->board, p->type, p->rotation, p->x, p->y);
+    remove_lines(g, lock_piece(g));
+    spawn_piece(g);
+}
+
+void tetris_apply_actions(TetrisGame *g, uint8_t actions){
+    if(actions & TETRIS_ACTION_ROT_CCW)    tetris_rotate_counter(g);
+    if(actions & TETRIS_ACTION_ROT_CW)     tetris_rotate_clockwise(g);
+    if(actions & TETRIS_ACTION_HARD_DROP)  tetris_hard_drop(g);
+    if(actions & TETRIS_ACTION_LEFT)       tetris_move_left(g);
+    if(actions & TETRIS_ACTION_RIGHT)      tetris_move_right(g);
+    if(actions & TETRIS_ACTION_SOFT_DROP)  tetris_soft_drop(g);
+    if(actions & TETRIS_ACTION_ROT_CW_JOY) tetris_rotate_clockwise(g);
+}
+
+bool tetris_is_game_over(const TetrisGame *g){
+    return g->game_over;
+}
+
+uint32_t tetris_get_score(const TetrisGame *g){
+    return g->score;
+}
+
+static uint32_t fnv1a(uint32_t h, const void *data, size_t len){
+    const uint8_t *p = (const uint8_t *)data;
+    for(size_t i=0; i<len; i++){
+        h ^= p[i];
+        h *= 16777619u;
     }
-    lock_piece();
-    remove_lines();
-    spawn_piece();
+    return h;
+}
+
+uint32_t tetris_hash(const TetrisGame *g){
+    uint32_t h = 2166136261u;
+    h = fnv1a(h, g->board.rows, sizeof(g->board.rows));
+    h = fnv1a(h, g->board.colors, sizeof(g->board.colors));
+    h = fnv1a(h, &g->score, sizeof(g->score));
+    return h;
+}
+
+uint8_t tetris_take_events(TetrisGame *g){
+    uint8_t ev = g->events;
+    g->events = 0;
+    return ev;
 }
 
-bool tetris_is_game_over(void){
-    return game_over;
+void tetris_snapshot(const TetrisGame *g, TetrisSnapshot *s){
+    memcpy(s->rows, g->board.rows, sizeof(s->rows));
+    s->current   = g->current;
+    s->ghost_y   = g->game_over ? g->current.y
+                 : (int8_t)tetris_board_drop_y(&g->board, g->current.type, g->current.rotation,
+                                               g->current.x, g->current.y);
+    s->next_type = g->next.type;
+    s->game_over = g->game_over;
+    s->banner    = false;
+    s->piece_hidden = false;
+    s->score     = g->score;
 }
 
-uint32_t tetris_get_score(void){
-    return score;
+void tetris_draw(const TetrisGame *g, ssd1306_t *fb) {
+    TetrisSnapshot s;
+    tetris_snapshot(g, &s);
+    tetris_draw_snapshot(&s, fb);
 }
 
 /**
- * tetris_draw: desenha o estado do Tetris no display SSD1306
- * Cada célula ~ 4x4 px (ou 6x6, etc.) 
+ * tetris_draw_snapshot: desenha o estado do Tetris no framebuffer 'fb'
+ * Cada célula ~ 4x4 px (ou 6x6, etc.)
  */
-void tetris_draw(void) {
+void tetris_draw_snapshot(const TetrisSnapshot *s, ssd1306_t *fb) {
     // Apaga display
-    ssd1306_clear(&g_oled_dev);
+    ssd1306_clear(fb);
 
-    const int cell_w = 6; 
+    const int cell_w = 6;
     const int cell_h = 6;
 
     // Desenha o board
     for(int y=0; y< TETRIS_HEIGHT; y++){
+        uint16_t row= s->rows[y];
         for(int x=0; x< TETRIS_WIDTH; x++){
-            int c= board[x][y];
-            if(c!=0){
-                ssd1306_fill_rect(&g_oled_dev,
+            if(row & TETRIS_CELL_BIT(x)){
+                ssd1306_fill_rect(fb,
                     x*cell_w, y*cell_h,
                     cell_w, cell_h,
                     true);
@@ -285,23 +275,65 @@ void tetris_draw(void) {
         }
     }
 
+    if(s->piece_hidden){
+        if(s->banner) tetris_draw_banner(s, fb);
+        return;
+    }
+
+    // Contorno da peça fantasma, onde a atual vai pousar
+    const TetrisPiece *p= &s->current;
+    const uint8_t *m= tetris_piece_rows[p->type][p->rotation];
+    for(int row=0; row<4; row++){
+        for(int col=0; col<4; col++){
+            if(m[row] & (1u<<col)){
+                ssd1306_rect(fb,
+                    (p->x+col)*cell_w, (s->ghost_y+row)*cell_h,
+                    cell_w, cell_h,
+                    true, false);
+            }
+        }
+    }
+
     // Desenha a peça atual
-    unsigned int blocks= current.shape[current.rotation];
-    unsigned int bit=0x8000;
-    int row=0, col=0;
-    for(;bit>0; bit>>=1){
-        if(blocks & bit){
-            int bx= current.x+col;
-            int by= current.y+row;
-            ssd1306_fill_rect(&g_oled_dev,
-                bx*cell_w, by*cell_h,
-                cell_w, cell_h,
-                true);
+    for(int row=0; row<4; row++){
+        for(int col=0; col<4; col++){
+            if(m[row] & (1u<<col)){
+                int bx= p->x+col;
+                int by= p->y+row;
+                ssd1306_fill_rect(fb,
+                    bx*cell_w, by*cell_h,
+                    cell_w, cell_h,
+                    true);
+            }
         }
-        col++;
-        if(col==4){col=0; row++;}
     }
+    if(s->banner) tetris_draw_banner(s, fb);
+}
+
+// Caixa do banner, em coordenadas lógicas (64 de largura, 8 letras de 8 px);
+// ssd1306_draw_string para de escrever com y+8 >= 64, então fica no alto
+#define BANNER_W 64
+#define BANNER_Y 22
+#define BANNER_H 34
+
+static void draw_centered(ssd1306_t *fb, const char *str, int len, uint8_t y) {
+    ssd1306_draw_string(fb, str, (uint8_t)((BANNER_W - 8 * len) / 2), y);
+}
 
-    // Conclui enviando ao display
-    ssd1306_show(&g_oled_dev);
+void tetris_draw_banner(const TetrisSnapshot *s, ssd1306_t *fb) {
+    ssd1306_fill_rect(fb, 0, BANNER_Y, BANNER_W, BANNER_H, false);
+    ssd1306_rect(fb, 0, BANNER_Y, BANNER_W, BANNER_H, true, false);
+    draw_centered(fb, "GAME", 4, BANNER_Y + 3);
+    draw_centered(fb, "OVER", 4, BANNER_Y + 12);
+
+    // placar em decimal, sem printf (roda no core1)
+    char digits[11];
+    int n = 0;
+    uint32_t v = s->score;
+    do {
+        digits[sizeof(digits) - 2 - n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while(v && n < 8);
+    digits[sizeof(digits) - 1] = '\0';
+    draw_centered(fb, &digits[sizeof(digits) - 1 - n], n, BANNER_Y + 23);
 }
@@ -3,24 +3,131 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "tetris_board.h"
+#include "piece_queue.h"
+#include "ssd1306.h"
 
-#define TETRIS_WIDTH  10
-#define TETRIS_HEIGHT 20
+typedef struct {
+    int8_t  type;     // 0..6, índice em tetris_piece_rows
+    int8_t  x, y;
+    uint8_t rotation; // 0..3
+    uint8_t color_id; // 1..7
+} TetrisPiece;
 
-void tetris_init(void);
-void tetris_update(uint32_t dt_ms);
+// Eventos acumulados desde a última tetris_take_events (para som, LEDs...)
+#define TETRIS_EVENT_MOVE      (1u << 0)
+#define TETRIS_EVENT_ROTATE    (1u << 1)
+#define TETRIS_EVENT_LOCK      (1u << 2)
+#define TETRIS_EVENT_LINES     (1u << 3)
+#define TETRIS_EVENT_GAME_OVER (1u << 4)
 
-void tetris_move_left(void);
-void tetris_move_right(void);
-void tetris_rotate_clockwise(void);
-void tetris_rotate_counter(void);
-void tetris_soft_drop(void);
-void tetris_hard_drop(void);
+// Ações de entrada de um frame, aplicadas nesta ordem por tetris_apply_actions
+#define TETRIS_ACTION_ROT_CCW    (1u << 0) // botão A
+#define TETRIS_ACTION_ROT_CW     (1u << 1) // botão B
+#define TETRIS_ACTION_HARD_DROP  (1u << 2) // botão do joystick
+#define TETRIS_ACTION_LEFT       (1u << 3)
+#define TETRIS_ACTION_RIGHT      (1u << 4)
+#define TETRIS_ACTION_SOFT_DROP  (1u << 5)
+#define TETRIS_ACTION_ROT_CW_JOY (1u << 6) // joystick para cima
+#define TETRIS_NUM_ACTIONS       7
 
-bool tetris_is_game_over(void);
-uint32_t tetris_get_score(void);
+// Gravidade: o intervalo cai 20 ms por linha enquanto estiver acima do
+// piso. No modo 20G (tetris_set_20g) a peça pousa na hora e o intervalo é
+// o tempo até ela travar, contado a partir da entrada de cada peça.
+#define TETRIS_GRAVITY_START_MS  800
+#define TETRIS_GRAVITY_FLOOR_MS  100
+#define TETRIS_LOCK_DELAY_20G_MS 500
 
-// Desenha no SSD1306
-void tetris_draw(void);
+/**
+ * Estado completo de uma partida. Tamanho fixo, sem heap e sem estado
+ * global: várias partidas podem rodar lado a lado.
+ */
+typedef struct {
+    TetrisBoard board;
+    TetrisPiece current;
+    TetrisPiece next;
+    uint32_t    score;
+    uint32_t    gravity_interval;
+    uint32_t    gravity_timer;
+    PieceQueue  queue;    // peças depois da atual; a cabeça é next
+    uint32_t    pieces;   // peças que já entraram em jogo
+    uint32_t    lines;    // linhas removidas na partida
+    uint32_t    generation; // muda a cada alteração visível (peça, tabuleiro, placar, prévia)
+    uint32_t    cleared_rows; // bit y: linhas removidas pela última trava (y de antes do colapso)
+    uint8_t     events;
+    bool        gravity_20g;
+    bool        game_over;
+} TetrisGame;
+
+#define TETRIS_PREVIEW PIECE_QUEUE_LEN
+
+/** Partida nova; a sequência de peças depende só de seed e mode. */
+void tetris_init(TetrisGame *g, uint32_t seed, PieceRandomizer mode);
+
+/** Liga o modo 20G na partida recém-iniciada (tetris_init volta ao normal). */
+void tetris_set_20g(TetrisGame *g, bool on);
+
+/** Tipo da i-ésima peça que vai entrar depois da atual (0 = next), i < TETRIS_PREVIEW. */
+int tetris_peek(const TetrisGame *g, int i);
+
+/** Avança a gravidade em dt_ms; várias chamadas equivalem a uma com a soma dos dt. */
+void tetris_update(TetrisGame *g, uint32_t dt_ms);
+
+void tetris_move_left(TetrisGame *g);
+void tetris_move_right(TetrisGame *g);
+void tetris_rotate_clockwise(TetrisGame *g);
+void tetris_rotate_counter(TetrisGame *g);
+void tetris_soft_drop(TetrisGame *g);
+void tetris_hard_drop(TetrisGame *g);
+
+/** Aplica as ações TETRIS_ACTION_* de um frame, na ordem dos bits. */
+void tetris_apply_actions(TetrisGame *g, uint8_t actions);
+
+bool tetris_is_game_over(const TetrisGame *g);
+uint32_t tetris_get_score(const TetrisGame *g);
+
+/** Hash (FNV-1a) do tabuleiro e do placar, para conferir replays. */
+uint32_t tetris_hash(const TetrisGame *g);
+
+/**
+ * Geração do estado visível: igual entre duas chamadas => nada mudou na
+ * tela (só timers), e o frame pode ser pulado. Recomeça em tetris_init.
+ */
+static inline uint32_t tetris_generation(const TetrisGame *g) { return g->generation; }
+
+/** Tempo de simulação (ms) até o próximo passo da gravidade; UINT32_MAX no game over. */
+static inline uint32_t tetris_gravity_due_ms(const TetrisGame *g) {
+    if(g->game_over) return UINT32_MAX;
+    return g->gravity_timer < g->gravity_interval ? g->gravity_interval - g->gravity_timer : 0;
+}
+
+/** Retorna e zera os eventos TETRIS_EVENT_* acumulados. */
+uint8_t tetris_take_events(TetrisGame *g);
+
+/**
+ * Cópia compacta do que a tela precisa de uma partida, para entregar a
+ * outro core sem compartilhar o TetrisGame (ver render_core.h).
+ */
+typedef struct {
+    uint16_t    rows[TETRIS_HEIGHT]; // máscaras do tabuleiro (com paredes)
+    TetrisPiece current;
+    int8_t      ghost_y;   // linha onde a peça atual pousaria
+    int8_t      next_type;
+    bool        game_over;
+    bool        banner;    // placar por cima do tabuleiro (animação de game over)
+    bool        piece_hidden; // sem peça atual nem fantasma (linhas piscando)
+    uint32_t    score;
+    uint32_t    seq;       // número do frame que gerou o snapshot
+    uint32_t    stamp_us;  // instante da amostragem da entrada
+} TetrisSnapshot;
+
+void tetris_snapshot(const TetrisGame *g, TetrisSnapshot *s);
+
+// Desenha no framebuffer do SSD1306 (não envia ao display)
+void tetris_draw(const TetrisGame *g, ssd1306_t *fb);
+void tetris_draw_snapshot(const TetrisSnapshot *s, ssd1306_t *fb);
+
+/** Caixa "GAME OVER" + placar no meio do tabuleiro (snapshot com banner). */
+void tetris_draw_banner(const TetrisSnapshot *s, ssd1306_t *fb);
 
 #endif
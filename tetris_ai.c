@@ -0,0 +1,262 @@
+#include "tetris_ai.h"
+#include <string.h>
+
+#define PLAYFIELD ((uint16_t)~TETRIS_ROW_EMPTY)
+
+// Nota de um encaixe que termina a partida: pior que qualquer outro,
+// mas ainda melhor que "nenhum encaixe" (INT32_MIN)
+#define SCORE_TOP_OUT (INT32_MIN + 1)
+
+typedef struct {
+    uint8_t rotation;
+    int8_t  x;
+    int8_t  y; // altura de onde sai o hard drop
+} Placement;
+
+// No máximo 4 rotações x 13 colunas de x (de -3 a 9)
+#define MAX_PLACEMENTS (4 * (TETRIS_WIDTH + TETRIS_WALL_LEFT))
+
+void tetris_ai_default_config(TetrisAiConfig *cfg, uint8_t depth) {
+    // Pesos x1000, na linha dos de El-Tetris (altura, linhas, buracos,
+    // irregularidade) com um termo pequeno para poços
+    cfg->weights[TETRIS_AI_HEIGHT]     = -510;
+    cfg->weights[TETRIS_AI_HOLES]      = -357;
+    cfg->weights[TETRIS_AI_BUMPINESS]  = -184;
+    cfg->weights[TETRIS_AI_LINES]      =  761;
+    cfg->weights[TETRIS_AI_WELLS]      =  -50;
+    cfg->weights[TETRIS_AI_MAX_HEIGHT] =    0;
+    if(depth < 1) depth = 1;
+    if(depth > TETRIS_AI_MAX_DEPTH) depth = TETRIS_AI_MAX_DEPTH;
+    cfg->depth = depth;
+}
+
+// -------------------------------------------------------------------
+// Tabuleiro só de máscaras (mesma convenção de tetris_board.h)
+// -------------------------------------------------------------------
+
+static bool collides(const uint16_t *rows, const uint8_t *m, int x, int y) {
+    if(x < -TETRIS_WALL_LEFT || x >= TETRIS_WIDTH) return true;
+    unsigned shift = (unsigned)(x + TETRIS_WALL_LEFT);
+    for(int r=0; r<4; r++){
+        if(!m[r]) continue;
+        int by = y + r;
+        if(by < 0 || by >= TETRIS_HEIGHT) return true;
+        if(rows[by] & ((unsigned)m[r] << shift)) return true;
+    }
+    return false;
+}
+
+static int land(const uint16_t *rows, const uint8_t *m, int x, int y) {
+    while(!collides(rows, m, x, y + 1)) y++;
+    return y;
+}
+
+/** Larga a peça a partir de y, trava e remove as linhas; retorna as linhas. */
+static int drop_and_lock(uint16_t *rows, const uint8_t *m, int x, int y) {
+    y = land(rows, m, x, y);
+
+    unsigned shift = (unsigned)(x + TETRIS_WALL_LEFT);
+    unsigned full = 0;
+    for(int r=0; r<4; r++){
+        if(!m[r]) continue;
+        rows[y + r] |= (uint16_t)((unsigned)m[r] << shift);
+        if(rows[y + r] == TETRIS_ROW_FULL) full |= 1u << r;
+    }
+    if(!full) return 0;
+
+    int dst = y + 3 < TETRIS_HEIGHT ? y + 3 : TETRIS_HEIGHT - 1;
+    int lines = 0;
+    for(int src=dst; src>=0; src--){
+        int r = src - y;
+        if(r >= 0 && r < 4 && (full & (1u << r))){
+            lines++;
+            continue;
+        }
+        rows[dst--] = rows[src];
+    }
+    while(dst >= 0) rows[dst--] = TETRIS_ROW_EMPTY;
+    return lines;
+}
+
+static int32_t evaluate(const uint16_t *rows, int lines, const int32_t *w) {
+    int h[TETRIS_WIDTH] = {0};
+    uint16_t seen = 0;
+    int holes = 0;
+    for(int y=0; y<TETRIS_HEIGHT; y++){
+        uint16_t occ = rows[y] & PLAYFIELD;
+        uint16_t fresh = occ & (uint16_t)~seen;
+        while(fresh){
+            h[__builtin_ctz(fresh) - TETRIS_WALL_LEFT] = TETRIS_HEIGHT - y;
+            fresh &= (uint16_t)(fresh - 1);
+        }
+        holes += __builtin_popcount(seen & (uint16_t)~occ);
+        seen |= occ;
+    }
+
+    int height = 0, bump = 0, wells = 0, max_h = 0;
+    for(int x=0; x<TETRIS_WIDTH; x++){
+        height += h[x];
+        if(h[x] > max_h) max_h = h[x];
+        if(x + 1 < TETRIS_WIDTH) bump += h[x] > h[x+1] ? h[x] - h[x+1] : h[x+1] - h[x];
+        int left  = x > 0 ? h[x-1] : TETRIS_HEIGHT;
+        int right = x + 1 < TETRIS_WIDTH ? h[x+1] : TETRIS_HEIGHT;
+        int rim = left < right ? left : right;
+        if(rim > h[x]) wells += rim - h[x];
+    }
+
+    return w[TETRIS_AI_HEIGHT]     * height
+         + w[TETRIS_AI_HOLES]      * holes
+         + w[TETRIS_AI_BUMPINESS]  * bump
+         + w[TETRIS_AI_LINES]      * lines
+         + w[TETRIS_AI_WELLS]      * wells
+         + w[TETRIS_AI_MAX_HEIGHT] * max_h;
+}
+
+/**
+ * Encaixes alcançáveis a partir de (rot0, x0, y0), do jeito que
+ * tetris_ai_execute os executa: primeiro as rotações no lugar (até 2 no
+ * horário ou 1 no anti-horário), depois os deslocamentos laterais na
+ * mesma altura, depois o hard drop.
+ *
+ * Em 20G (g20) a peça pousa depois de cada passo, como em tetris.c: cada
+ * rotação e cada deslocamento parte da altura em que o anterior pousou.
+ */
+static int enumerate(const uint16_t *rows, int type, int rot0, int x0, int y0,
+                     bool g20, Placement *out)
+{
+    int n = 0;
+    bool ok[4];
+    int  ry[4];
+    int cw1 = (rot0 + 1) & 3, cw2 = (rot0 + 2) & 3, ccw = (rot0 + 3) & 3;
+    const uint8_t (*m4)[4] = tetris_piece_rows[type];
+
+    ok[rot0] = !collides(rows, m4[rot0], x0, y0);
+    ry[rot0] = ok[rot0] && g20 ? land(rows, m4[rot0], x0, y0) : y0;
+    ok[cw1] = ok[rot0] && !collides(rows, m4[cw1], x0, ry[rot0]);
+    ry[cw1] = ok[cw1] && g20 ? land(rows, m4[cw1], x0, ry[rot0]) : y0;
+    ok[cw2] = ok[cw1]  && !collides(rows, m4[cw2], x0, ry[cw1]);
+    ry[cw2] = ok[cw2] && g20 ? land(rows, m4[cw2], x0, ry[cw1]) : y0;
+    ok[ccw] = ok[rot0] && !collides(rows, m4[ccw], x0, ry[rot0]);
+    ry[ccw] = ok[ccw] && g20 ? land(rows, m4[ccw], x0, ry[rot0]) : y0;
+
+    for(int r=0; r<4; r++){
+        if(!ok[r]) continue;
+        const uint8_t *m = m4[r];
+
+        // rotações com a mesma máscara dão os mesmos encaixes (peça O)
+        bool dup = false;
+        for(int q=0; q<r; q++){
+            if(ok[q] && memcmp(m4[q], m, 4) == 0) dup = true;
+        }
+        if(dup) continue;
+
+        // desliza até a parede/pilha de cada lado; a saída fica em x crescente
+        int8_t ys[TETRIS_WIDTH + TETRIS_WALL_LEFT];
+        int lo = x0, hi = x0, y = ry[r];
+        ys[x0 + TETRIS_WALL_LEFT] = (int8_t)y;
+        while(!collides(rows, m, lo - 1, y)){
+            lo--;
+            if(g20) y = land(rows, m, lo, y);
+            ys[lo + TETRIS_WALL_LEFT] = (int8_t)y;
+        }
+        y = ry[r];
+        while(!collides(rows, m, hi + 1, y)){
+            hi++;
+            if(g20) y = land(rows, m, hi, y);
+            ys[hi + TETRIS_WALL_LEFT] = (int8_t)y;
+        }
+        for(int x=lo; x<=hi; x++){
+            out[n].rotation = (uint8_t)r;
+            out[n].x = (int8_t)x;
+            out[n].y = ys[x + TETRIS_WALL_LEFT];
+            n++;
+        }
+    }
+    return n;
+}
+
+// -------------------------------------------------------------------
+
+TetrisAiMove tetris_ai_search(const TetrisGame *g, const TetrisAiConfig *cfg) {
+    TetrisAiMove best = { 0, 0, INT32_MIN, 0, false };
+    if(g->game_over) return best;
+
+    const TetrisPiece *cur = &g->current, *nxt = &g->next;
+    const uint8_t *next_spawn = tetris_piece_rows[nxt->type][nxt->rotation];
+
+    Placement first[MAX_PLACEMENTS], second[MAX_PLACEMENTS];
+    bool g20 = g->gravity_20g;
+    int n1 = enumerate(g->board.rows, cur->type, cur->rotation, cur->x, cur->y, g20, first);
+
+    for(int i=0; i<n1; i++){
+        uint16_t r1[TETRIS_HEIGHT];
+        memcpy(r1, g->board.rows, sizeof(r1));
+        int lines1 = drop_and_lock(r1, tetris_piece_rows[cur->type][first[i].rotation],
+                                   first[i].x, first[i].y);
+        best.evaluated++;
+
+        int32_t score;
+        if(collides(r1, next_spawn, nxt->x, nxt->y)){
+            score = SCORE_TOP_OUT;
+        } else if(cfg->depth < 2){
+            score = evaluate(r1, lines1, cfg->weights);
+        } else {
+            score = SCORE_TOP_OUT;
+            int n2 = enumerate(r1, nxt->type, nxt->rotation, nxt->x, nxt->y, g20, second);
+            for(int j=0; j<n2; j++){
+                uint16_t r2[TETRIS_HEIGHT];
+                memcpy(r2, r1, sizeof(r2));
+                int lines2 = drop_and_lock(r2, tetris_piece_rows[nxt->type][second[j].rotation],
+                                           second[j].x, second[j].y);
+                best.evaluated++;
+                int32_t s = evaluate(r2, lines1 + lines2, cfg->weights);
+                if(s > score) score = s;
+            }
+        }
+
+        if(score > best.score){
+            best.score    = score;
+            best.rotation = first[i].rotation;
+            best.x        = first[i].x;
+            best.valid    = true;
+        }
+    }
+    return best;
+}
+
+void tetris_ai_execute(TetrisGame *g, const TetrisAiMove *m) {
+    if(!m->valid || g->game_over) return;
+
+    int d = (m->rotation - g->current.rotation) & 3;
+    if(d == 3){
+        tetris_rotate_counter(g);
+    } else {
+        for(int i=0; i<d; i++) tetris_rotate_clockwise(g);
+    }
+
+    while(g->current.x > m->x){
+        int8_t before = g->current.x;
+        tetris_move_left(g);
+        if(g->current.x == before) break;
+    }
+    while(g->current.x < m->x){
+        int8_t before = g->current.x;
+        tetris_move_right(g);
+        if(g->current.x == before) break;
+    }
+    tetris_hard_drop(g);
+}
+
+void tetris_ai_init(TetrisAi *ai, const TetrisAiConfig *cfg) {
+    ai->cfg = *cfg;
+    ai->played_piece = 0;
+    memset(&ai->last, 0, sizeof(ai->last));
+}
+
+bool tetris_ai_step(TetrisAi *ai, TetrisGame *g) {
+    if(g->game_over || g->pieces == ai->played_piece) return false;
+    ai->last = tetris_ai_search(g, &ai->cfg);
+    ai->played_piece = g->pieces;
+    tetris_ai_execute(g, &ai->last);
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef TETRIS_AI_H
+#define TETRIS_AI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris.h"
+
+/**
+ * Jogador automático. A cada peça nova enumera todos os encaixes
+ * alcançáveis (rotação, coluna) de 'current' e, com profundidade 2,
+ * também de 'next' sobre cada resultado. Cada tabuleiro final recebe
+ * uma nota por soma ponderada de características, e o melhor encaixe é
+ * executado pela API normal (tetris_rotate_*, tetris_move_*,
+ * tetris_hard_drop).
+ *
+ * A busca roda só sobre as máscaras de linha (sem cores) e em
+ * aritmética inteira: o RP2040 não tem FPU.
+ */
+
+typedef enum {
+    TETRIS_AI_HEIGHT = 0, // soma das alturas das colunas
+    TETRIS_AI_HOLES,      // células vazias com bloco em cima
+    TETRIS_AI_BUMPINESS,  // soma de |h[x] - h[x+1]|
+    TETRIS_AI_LINES,      // linhas completadas pelos encaixes
+    TETRIS_AI_WELLS,      // profundidade somada dos poços (colunas abaixo das duas vizinhas)
+    TETRIS_AI_MAX_HEIGHT, // coluna mais alta
+    TETRIS_AI_NUM_FEATURES
+} TetrisAiFeature;
+
+#define TETRIS_AI_MAX_DEPTH 2
+
+typedef struct {
+    int32_t weights[TETRIS_AI_NUM_FEATURES]; // nota = soma(peso * valor)
+    uint8_t depth;                           // 1 = só current, 2 = current + next
+} TetrisAiConfig;
+
+/** Encaixe escolhido para 'current'. */
+typedef struct {
+    uint8_t  rotation;
+    int8_t   x;
+    int32_t  score;       // nota do melhor tabuleiro final
+    uint32_t evaluated;   // encaixes avaliados na busca (todas as profundidades)
+    bool     valid;       // false se nenhum encaixe é alcançável
+} TetrisAiMove;
+
+/** Pesos padrão e profundidade 'depth' (1..TETRIS_AI_MAX_DEPTH). */
+void tetris_ai_default_config(TetrisAiConfig *cfg, uint8_t depth);
+
+/** Procura o melhor encaixe para a peça atual, sem alterar a partida. */
+TetrisAiMove tetris_ai_search(const TetrisGame *g, const TetrisAiConfig *cfg);
+
+/** Executa 'm' pela API da partida: gira, desloca e faz hard drop. */
+void tetris_ai_execute(TetrisGame *g, const TetrisAiMove *m);
+
+/** Estado do jogador entre frames: joga uma vez por peça nova. */
+typedef struct {
+    TetrisAiConfig cfg;
+    uint32_t       played_piece; // g->pieces da última peça jogada
+    TetrisAiMove   last;
+} TetrisAi;
+
+void tetris_ai_init(TetrisAi *ai, const TetrisAiConfig *cfg);
+
+/** Se há peça nova, busca e executa o encaixe; true se jogou. */
+bool tetris_ai_step(TetrisAi *ai, TetrisGame *g);
+
+#endif
@@ -0,0 +1,145 @@
+#include "tetris_board.h"
+#include <string.h>  // memset, memcpy
+
+// As formas continuam escritas no formato antigo (16 bits, linha 0 no nibble
+// mais alto e coluna 0 no bit mais alto do nibble) e são convertidas em
+// máscaras por linha em tempo de compilação.
+#define NIBBLE(s, r)  (((s) >> (12 - 4*(r))) & 0xF)
+#define REV4(n)       ((((n)&1)<<3) | (((n)&2)<<1) | (((n)&4)>>1) | (((n)&8)>>3))
+#define ROWS(s)       { REV4(NIBBLE(s,0)), REV4(NIBBLE(s,1)), REV4(NIBBLE(s,2)), REV4(NIBBLE(s,3)) }
+#define PIECE(a,b,c,d) { ROWS(a), ROWS(b), ROWS(c), ROWS(d) },
+
+// Linha mais baixa da coluna c na forma s (-1 se a coluna é vazia)
+#define HAS(s, r, c)  ((REV4(NIBBLE(s,r)) >> (c)) & 1)
+#define BOT(s, c)     (HAS(s,3,c) ? 3 : HAS(s,2,c) ? 2 : HAS(s,1,c) ? 1 : HAS(s,0,c) ? 0 : -1)
+#define BOTS(s)       { BOT(s,0), BOT(s,1), BOT(s,2), BOT(s,3) }
+#define BOTTOM(a,b,c,d) { BOTS(a), BOTS(b), BOTS(c), BOTS(d) },
+
+#define SHAPES(X)                      \
+    X(0x0F00,0x2222,0x00F0,0x4444) /* I */ \
+    X(0xCC00,0xCC00,0xCC00,0xCC00) /* O */ \
+    X(0x0E40,0x4C40,0x4E00,0x4640) /* T */ \
+    X(0x06C0,0x8C40,0x6C00,0x4620) /* S */ \
+    X(0x0C60,0x4C80,0xC600,0x2640) /* Z */ \
+    X(0x44C0,0x8E00,0x6440,0x0E20) /* J */ \
+    X(0x4460,0x0E80,0xC440,0x2E00) /* L */
+
+const uint8_t tetris_piece_rows[TETRIS_NUM_PIECES][4][4] = { SHAPES(PIECE) };
+const int8_t tetris_piece_bottom[TETRIS_NUM_PIECES][4][4] = { SHAPES(BOTTOM) };
+
+void tetris_board_clear(TetrisBoard *b){
+    for(int y=0; y<TETRIS_HEIGHT; y++){
+        b->rows[y] = TETRIS_ROW_EMPTY;
+    }
+    memset(b->colors, 0, sizeof(b->colors));
+    memset(b->heights, 0, sizeof(b->heights));
+    b->top = TETRIS_HEIGHT;
+}
+
+bool tetris_board_collides(const TetrisBoard *b, int type, int rot, int x, int y){
+    // Fora desta faixa a peça 4x4 não cabe nem parcialmente entre as paredes
+    if(x < -TETRIS_WALL_LEFT || x >= TETRIS_WIDTH) return true;
+
+    const uint8_t *m = tetris_piece_rows[type][rot];
+    unsigned shift = (unsigned)(x + TETRIS_WALL_LEFT);
+    for(int r=0; r<4; r++){
+        if(!m[r]) continue;
+        int by = y + r;
+        if(by < 0 || by >= TETRIS_HEIGHT) return true;
+        if(b->rows[by] & ((unsigned)m[r] << shift)) return true;
+    }
+    return false;
+}
+
+static void set_color(TetrisBoard *b, int x, int y, uint8_t color){
+    uint8_t *cell = &b->colors[y][x >> 1];
+    int sh = (x & 1) * 4;
+    *cell = (uint8_t)((*cell & ~(0x0F << sh)) | ((color & 0x0F) << sh));
+}
+
+TetrisRowSpan tetris_board_lock(TetrisBoard *b, int type, int rot, int x, int y, uint8_t color){
+    const uint8_t *m = tetris_piece_rows[type][rot];
+    TetrisRowSpan span = { TETRIS_HEIGHT, 0 };
+    for(int r=0; r<4; r++){
+        if(!m[r]) continue;
+        int by = y + r;
+        b->rows[by] |= (uint16_t)((unsigned)m[r] << (x + TETRIS_WALL_LEFT));
+        for(int c=0; c<4; c++){
+            if(m[r] & (1u << c)){
+                set_color(b, x + c, by, color);
+                if(TETRIS_HEIGHT - by > b->heights[x + c]) b->heights[x + c] = (int8_t)(TETRIS_HEIGHT - by);
+            }
+        }
+        if(span.count == 0) span.top = (int8_t)by;
+        span.count = (uint8_t)(by - span.top + 1);
+    }
+    if(span.top < b->top) b->top = span.top;
+    return span;
+}
+
+uint32_t tetris_board_remove_lines(TetrisBoard *b, TetrisRowSpan touched){
+    unsigned full = 0; // bit i => linha touched.top+i completa
+    for(int i=0; i<touched.count; i++){
+        if(b->rows[touched.top + i] == TETRIS_ROW_FULL) full |= 1u << i;
+    }
+    if(!full) return 0;
+
+    // Compacta de baixo para cima numa única passada: cada linha que
+    // sobrevive é movida no máximo uma vez, e nada acima de 'top' é tocado.
+    int bottom = touched.top + touched.count - 1;
+    int dst = bottom;
+    for(int y=bottom; y>=b->top; y--){
+        if(y >= touched.top && (full & (1u << (y - touched.top)))) continue;
+        if(dst != y){
+            b->rows[dst] = b->rows[y];
+            memcpy(b->colors[dst], b->colors[y], sizeof(b->colors[0]));
+        }
+        dst--;
+    }
+
+    int cleared = dst - b->top + 1;
+    for(int y=b->top; y<=dst; y++){
+        b->rows[y] = TETRIS_ROW_EMPTY;
+        memset(b->colors[y], 0, sizeof(b->colors[0]));
+    }
+    b->top = (int8_t)(b->top + cleared);
+
+    // Alturas: se o topo da coluna sobreviveu, ela só baixa das linhas
+    // removidas abaixo dele; se o topo estava numa linha removida, procura
+    // o novo topo no tabuleiro já compactado.
+    for(int x=0; x<TETRIS_WIDTH; x++){
+        int h = b->heights[x];
+        if(h == 0) continue;
+        int t = TETRIS_HEIGHT - h;
+        int rel = t - touched.top;
+        if(rel >= 0 && rel < touched.count && (full & (1u << rel))){
+            int y = b->top;
+            while(y < TETRIS_HEIGHT && !(b->rows[y] & TETRIS_CELL_BIT(x))) y++;
+            b->heights[x] = (int8_t)(TETRIS_HEIGHT - y);
+        } else {
+            unsigned below = rel < 0 ? full : full >> (rel + 1);
+            b->heights[x] = (int8_t)(h - __builtin_popcount(below));
+        }
+    }
+    return (uint32_t)full << touched.top;
+}
+
+int tetris_board_drop_y(const TetrisBoard *b, int type, int rot, int x, int y){
+    const int8_t *bot = tetris_piece_bottom[type][rot];
+    int land = TETRIS_HEIGHT;
+    for(int c=0; c<4; c++){
+        if(bot[c] < 0) continue;
+        int surface = TETRIS_HEIGHT - b->heights[x + c]; // 1ª linha ocupada da coluna
+        if(y + bot[c] >= surface){
+            // peça abaixo do topo desta coluna (sob uma saliência)
+            while(!tetris_board_collides(b, type, rot, x, y + 1)) y++;
+            return y;
+        }
+        if(surface - 1 - bot[c] < land) land = surface - 1 - bot[c];
+    }
+    return land;
+}
+
+uint8_t tetris_board_color(const TetrisBoard *b, int x, int y){
+    return (uint8_t)((b->colors[y][x >> 1] >> ((x & 1) * 4)) & 0x0F);
+}
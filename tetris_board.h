@@ -0,0 +1,71 @@
+#ifndef TETRIS_BOARD_H
+#define TETRIS_BOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TETRIS_WIDTH  10
+#define TETRIS_HEIGHT 20
+
+#define TETRIS_NUM_PIECES 7
+
+/**
+ * Cada linha do tabuleiro é uma máscara de 16 bits: a coluna x fica no bit
+ * (x + TETRIS_WALL_LEFT). Os bits fora do tabuleiro ficam sempre em 1
+ * (paredes), então a colisão com as laterais sai no mesmo AND da colisão
+ * com os blocos.
+ */
+#define TETRIS_WALL_LEFT  3
+#define TETRIS_CELL_BIT(x) ((uint16_t)(1u << ((x) + TETRIS_WALL_LEFT)))
+#define TETRIS_ROW_FULL   ((uint16_t)0xFFFFu)
+#define TETRIS_ROW_EMPTY  ((uint16_t)~(((1u << TETRIS_WIDTH) - 1u) << TETRIS_WALL_LEFT))
+
+typedef struct {
+    uint16_t rows[TETRIS_HEIGHT];                         // ocupação + paredes
+    uint8_t  colors[TETRIS_HEIGHT][(TETRIS_WIDTH + 1) / 2]; // cor 1..7, 4 bits por célula
+    int8_t   top;                                         // 1ª linha não vazia (TETRIS_HEIGHT = vazio)
+    int8_t   heights[TETRIS_WIDTH];                       // altura da superfície de cada coluna (0 = vazia)
+} TetrisBoard;
+
+/** Faixa de linhas [top, top+count) tocada por um lock. */
+typedef struct {
+    int8_t  top;
+    uint8_t count;
+} TetrisRowSpan;
+
+/**
+ * Máscaras pré-calculadas de cada peça: [tipo][rotação][linha], 4 bits
+ * por linha com a coluna 0 da peça no bit 0.
+ */
+extern const uint8_t tetris_piece_rows[TETRIS_NUM_PIECES][4][4];
+
+/** Linha mais baixa ocupada de cada coluna da peça: [tipo][rotação][coluna], -1 se vazia. */
+extern const int8_t tetris_piece_bottom[TETRIS_NUM_PIECES][4][4];
+
+/** Esvazia o tabuleiro. */
+void tetris_board_clear(TetrisBoard *b);
+
+/** true se a peça (tipo, rotação) em (x,y) sai do tabuleiro ou sobrepõe blocos. */
+bool tetris_board_collides(const TetrisBoard *b, int type, int rot, int x, int y);
+
+/** Grava a peça no tabuleiro com a cor indicada e retorna as linhas (1..4) tocadas. */
+TetrisRowSpan tetris_board_lock(TetrisBoard *b, int type, int rot, int x, int y, uint8_t color);
+
+/**
+ * Remove as linhas completas dentro de 'touched' (só elas podem ter
+ * completado no último lock) e retorna quais: bit y = linha y de antes
+ * do colapso (__builtin_popcount dá quantas).
+ */
+uint32_t tetris_board_remove_lines(TetrisBoard *b, TetrisRowSpan touched);
+
+/**
+ * Linha onde a peça em (x,y), sem colidir, pousa se cair em linha reta.
+ * Com a peça acima da superfície em todas as suas colunas, sai das
+ * alturas em poucas consultas; sob uma saliência, desce linha a linha.
+ */
+int tetris_board_drop_y(const TetrisBoard *b, int type, int rot, int x, int y);
+
+/** Cor da célula (0 = vazia). */
+uint8_t tetris_board_color(const TetrisBoard *b, int x, int y);
+
+#endif
@@ -0,0 +1,139 @@
+#include "tetris_render.h"
+#include <string.h>
+
+#define TILE     6   // lado da célula em pixels
+#define SCREEN_W 128 // colunas físicas (eixo y lógico)
+#define SCREEN_H 64  // linhas físicas (eixo x lógico, invertido)
+
+_Static_assert(TILE * TETRIS_WIDTH <= SCREEN_H, "tabuleiro não cabe na altura do painel");
+_Static_assert(TILE * TETRIS_HEIGHT <= SCREEN_W, "tabuleiro não cabe na largura do painel");
+
+#define PLAYFIELD_BITS ((uint16_t)~TETRIS_ROW_EMPTY)
+
+/**
+ * Posição de cada coluna x do tabuleiro no painel. Com a rotação de
+ * ssd1306_pixel (px = ly, py = H-1-lx), a célula (x,y) ocupa as colunas
+ * físicas [6y, 6y+5] e as linhas [H-6(x+1), H-1-6x], que caem em uma ou
+ * duas páginas. Cada página recebe uma máscara fixa, a mesma para as 6
+ * colunas e para qualquer y. Para o contorno da peça fantasma, as colunas
+ * do meio da célula só acendem as linhas das pontas (edge_a/edge_b).
+ */
+typedef struct {
+    uint8_t page_a, mask_a, edge_a;
+    uint8_t page_b, mask_b, edge_b; // mask_b = 0 se a célula cabe numa página só
+} TileColumn;
+
+#define TILE_PY0(x) (SCREEN_H - TILE * ((x) + 1))
+#define TILE_PY1(x) (SCREEN_H - 1 - TILE * (x))
+#define TILE_SPLIT(x) ((TILE_PY0(x) >> 3) != (TILE_PY1(x) >> 3))
+#define TILE_MASK_LO(py) ((uint8_t)(0xFFu << ((py) & 7)))
+#define TILE_MASK_HI(py) ((uint8_t)(0xFFu >> (7 - ((py) & 7))))
+
+#define TILE_BIT(py) ((uint8_t)(1u << ((py) & 7)))
+
+#define TILE_COL(x) {                                                     \
+    TILE_PY0(x) >> 3,                                                     \
+    (uint8_t)(TILE_MASK_LO(TILE_PY0(x)) &                                 \
+              (TILE_SPLIT(x) ? 0xFFu : TILE_MASK_HI(TILE_PY1(x)))),       \
+    (uint8_t)(TILE_BIT(TILE_PY0(x)) |                                     \
+              (TILE_SPLIT(x) ? 0u : TILE_BIT(TILE_PY1(x)))),              \
+    TILE_PY1(x) >> 3,                                                     \
+    (uint8_t)(TILE_SPLIT(x) ? TILE_MASK_HI(TILE_PY1(x)) : 0u),            \
+    (uint8_t)(TILE_SPLIT(x) ? TILE_BIT(TILE_PY1(x)) : 0u) }
+
+static const TileColumn tile_columns[TETRIS_WIDTH] = {
+    TILE_COL(0), TILE_COL(1), TILE_COL(2), TILE_COL(3), TILE_COL(4),
+    TILE_COL(5), TILE_COL(6), TILE_COL(7), TILE_COL(8), TILE_COL(9),
+};
+
+typedef enum { CELL_EMPTY, CELL_FILLED, CELL_GHOST } CellKind;
+
+static inline void put_mask(uint8_t *p, uint8_t mask, uint8_t edge, CellKind kind) {
+    uint8_t keep = (uint8_t)~mask;
+    switch(kind){
+    case CELL_FILLED:
+        for(int i=0; i<TILE; i++) p[i] |= mask;
+        break;
+    case CELL_GHOST:
+        // contorno: colunas das pontas inteiras, as do meio só nas bordas
+        p[0] |= mask;
+        for(int i=1; i<TILE-1; i++) p[i] = (uint8_t)((p[i] & keep) | edge);
+        p[TILE-1] |= mask;
+        break;
+    default:
+        for(int i=0; i<TILE; i++) p[i] &= keep;
+        break;
+    }
+}
+
+static void put_cell(uint8_t *fb, int x, int y, CellKind kind) {
+    const TileColumn *c = &tile_columns[x];
+    put_mask(fb + c->page_a * SCREEN_W + y * TILE, c->mask_a, c->edge_a, kind);
+    if(c->mask_b) put_mask(fb + c->page_b * SCREEN_W + y * TILE, c->mask_b, c->edge_b, kind);
+}
+
+void tetris_renderer_init(TetrisRenderer *r) {
+    memset(r->shown, 0, sizeof(r->shown));
+    memset(r->ghost, 0, sizeof(r->ghost));
+    r->valid = false;
+    r->banner = false;
+}
+
+void tetris_renderer_invalidate(TetrisRenderer *r) {
+    r->valid = false;
+}
+
+uint32_t tetris_render(TetrisRenderer *r, const TetrisSnapshot *s, ssd1306_t *fb) {
+    if(fb->width != SCREEN_W || fb->height != SCREEN_H){
+        // tabelas feitas para 128x64; outros painéis pelo caminho genérico
+        tetris_draw_snapshot(s, fb);
+        return TETRIS_WIDTH * TETRIS_HEIGHT;
+    }
+
+    // as células sob o banner não estão em shown: redesenha tudo
+    if(r->banner && !s->banner) r->valid = false;
+    if(!r->valid){
+        ssd1306_clear(fb);
+        memset(r->shown, 0, sizeof(r->shown));
+        memset(r->ghost, 0, sizeof(r->ghost));
+        r->valid = true;
+    }
+
+    // ocupação do frame: tabuleiro + peça atual, nos bits do tabuleiro;
+    // a fantasma fica num plano à parte e perde para células cheias
+    uint16_t occ[TETRIS_HEIGHT], ghost[TETRIS_HEIGHT] = {0};
+    for(int y=0; y<TETRIS_HEIGHT; y++) occ[y] = s->rows[y];
+    const TetrisPiece *p = &s->current;
+    const uint8_t *m = tetris_piece_rows[p->type][p->rotation];
+    for(int row=0; row<4 && !s->piece_hidden; row++){
+        if(!m[row]) continue;
+        uint16_t bits = (uint16_t)(m[row] << (p->x + TETRIS_WALL_LEFT));
+        int y = p->y + row;
+        if(y >= 0 && y < TETRIS_HEIGHT) occ[y] |= bits;
+        y = s->ghost_y + row;
+        if(y >= 0 && y < TETRIS_HEIGHT) ghost[y] |= bits;
+    }
+
+    uint8_t *buf = fb->ram_buffer + 1;
+    uint32_t changed = 0;
+    for(int y=0; y<TETRIS_HEIGHT; y++){
+        uint16_t now  = (uint16_t)((occ[y] & PLAYFIELD_BITS) >> TETRIS_WALL_LEFT);
+        uint16_t gnow = (uint16_t)((ghost[y] & PLAYFIELD_BITS) >> TETRIS_WALL_LEFT) & (uint16_t)~now;
+        uint16_t diff = (uint16_t)((now ^ r->shown[y]) | (gnow ^ r->ghost[y]));
+        while(diff){
+            int x = __builtin_ctz(diff);
+            diff &= (uint16_t)(diff - 1);
+            CellKind kind = (now >> x) & 1 ? CELL_FILLED : (gnow >> x) & 1 ? CELL_GHOST : CELL_EMPTY;
+            // cheia por cima de fantasma: limpa antes o meio do contorno
+            if(kind == CELL_FILLED && ((r->ghost[y] >> x) & 1)) put_cell(buf, x, y, CELL_EMPTY);
+            put_cell(buf, x, y, kind);
+            changed++;
+        }
+        r->shown[y] = now;
+        r->ghost[y] = gnow;
+    }
+
+    r->banner = s->banner;
+    if(s->banner) tetris_draw_banner(s, fb);
+    return changed;
+}
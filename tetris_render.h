@@ -0,0 +1,40 @@
+#ifndef TETRIS_RENDER_H
+#define TETRIS_RENDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ssd1306.h"
+#include "tetris.h"
+
+/**
+ * Renderizador por tiles do tabuleiro direto nos bytes de página do
+ * SSD1306 (128x64 montado girado, células 6x6 e contorno da peça
+ * fantasma como tetris_draw).
+ *
+ * Guarda a ocupação que já está no framebuffer e, a cada frame, só
+ * reescreve as células que mudaram: o custo é proporcional às células
+ * alteradas, e o framebuffer só muda onde o envio diferencial
+ * (ssd1306_send_data) precisa mandar algo.
+ *
+ * O framebuffer passa a ser do renderizador: quem desenhar mais alguma
+ * coisa nele deve chamar tetris_renderer_invalidate. O banner do snapshot
+ * (tetris_draw_banner) é redesenhado por cima a cada frame e, quando some,
+ * a tela inteira é refeita.
+ */
+
+typedef struct {
+    uint16_t shown[TETRIS_HEIGHT]; // ocupação já desenhada, bit x = coluna x
+    uint16_t ghost[TETRIS_HEIGHT]; // contornos da peça fantasma já desenhados
+    bool     valid;                // false => limpa e redesenha tudo
+    bool     banner;               // banner desenhado por cima das células
+} TetrisRenderer;
+
+void tetris_renderer_init(TetrisRenderer *r);
+
+/** Força o próximo tetris_render a redesenhar a tela inteira. */
+void tetris_renderer_invalidate(TetrisRenderer *r);
+
+/** Atualiza 'fb' para o snapshot; retorna quantas células foram reescritas. */
+uint32_t tetris_render(TetrisRenderer *r, const TetrisSnapshot *s, ssd1306_t *fb);
+
+#endif
@@ -0,0 +1,270 @@
+/**
+ * Simulador em lote (host) para ajustar o tetris_ai: roda N partidas
+ * headless do motor de tetris.c, cada uma com sua semente, em todas as
+ * threads, e agrega linhas, placar e peças jogadas.
+ *
+ *   tetris_batch_sim [-n partidas] [-j threads] [-d profundidade]
+ *                    [-p max_pecas] [-s semente] [-w p0,p1,...] [-t iteracoes] [-u]
+ *
+ * A partida i usa a semente s+i, com 7-bag (ou sorteio uniforme com -u):
+ * o resultado não depende do número de threads.
+ *
+ * Com -t faz busca por descida coordenada nos pesos: a cada iteração
+ * tenta somar e subtrair o passo de cada peso, mantém o que aumentar a
+ * média de linhas (sempre sobre as mesmas sementes) e reduz o passo dos
+ * pesos que não melhoraram.
+ *
+ * Distribuição do trabalho: cada worker começa com uma faixa contígua de
+ * partidas e, quando ela acaba, rouba partidas das faixas dos outros.
+ * Tudo com um contador atômico por faixa, sem locks.
+ */
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "tetris_ai.h"
+
+#define MAX_THREADS 256
+
+typedef struct {
+    uint32_t lines;
+    uint32_t score;
+    uint32_t pieces;
+} GameResult;
+
+typedef struct {
+    _Atomic uint32_t next; // próxima partida da faixa
+    uint32_t end;
+    char pad[64 - 2 * sizeof(uint32_t)]; // uma faixa por linha de cache
+} WorkRange;
+
+typedef struct {
+    TetrisAiConfig cfg;
+    uint32_t seed;
+    uint32_t games;
+    uint32_t max_pieces;
+    int      threads;
+    PieceRandomizer randomizer;
+    bool     mode_20g;
+
+    GameResult *results;
+    WorkRange   ranges[MAX_THREADS];
+} Batch;
+
+typedef struct {
+    Batch *batch;
+    int    id;
+} Worker;
+
+typedef struct {
+    double   seconds;
+    double   mean_lines, mean_score, mean_pieces;
+    uint32_t min_lines, max_lines;
+    uint64_t pieces;
+} Summary;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void play_game(const Batch *b, uint32_t seed, GameResult *out) {
+    const TetrisAiConfig *cfg = &b->cfg;
+    uint32_t max_pieces = b->max_pieces;
+    TetrisGame g;
+    tetris_init(&g, seed, b->randomizer);
+    tetris_set_20g(&g, b->mode_20g);
+    while(!tetris_is_game_over(&g) && g.pieces < max_pieces){
+        TetrisAiMove m = tetris_ai_search(&g, cfg);
+        if(!m.valid) break;
+        tetris_ai_execute(&g, &m);
+    }
+    out->lines  = g.lines;
+    out->score  = g.score;
+    out->pieces = g.pieces;
+}
+
+static bool take(WorkRange *r, uint32_t *idx) {
+    if(atomic_load_explicit(&r->next, memory_order_relaxed) >= r->end) return false;
+    uint32_t i = atomic_fetch_add_explicit(&r->next, 1, memory_order_relaxed);
+    if(i >= r->end) return false;
+    *idx = i;
+    return true;
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = (Worker *)arg;
+    Batch *b = w->batch;
+    uint32_t idx;
+    for(int k=0; k<b->threads; k++){
+        // k = 0: própria faixa; depois as dos outros, em ordem
+        WorkRange *r = &b->ranges[(w->id + k) % b->threads];
+        while(take(r, &idx)){
+            play_game(b, b->seed + idx, &b->results[idx]);
+        }
+    }
+    return NULL;
+}
+
+static void run_batch(Batch *b, Summary *s) {
+    for(int t=0; t<b->threads; t++){
+        atomic_store(&b->ranges[t].next, (uint32_t)((uint64_t)b->games * t / b->threads));
+        b->ranges[t].end = (uint32_t)((uint64_t)b->games * (t + 1) / b->threads);
+    }
+
+    pthread_t th[MAX_THREADS];
+    Worker    wk[MAX_THREADS];
+    double t0 = now_s();
+    for(int t=0; t<b->threads; t++){
+        wk[t].batch = b;
+        wk[t].id = t;
+        pthread_create(&th[t], NULL, worker_main, &wk[t]);
+    }
+    for(int t=0; t<b->threads; t++) pthread_join(th[t], NULL);
+    s->seconds = now_s() - t0;
+
+    uint64_t lines = 0, score = 0;
+    s->pieces = 0;
+    s->min_lines = UINT32_MAX;
+    s->max_lines = 0;
+    for(uint32_t i=0; i<b->games; i++){
+        const GameResult *r = &b->results[i];
+        lines += r->lines;
+        score += r->score;
+        s->pieces += r->pieces;
+        if(r->lines < s->min_lines) s->min_lines = r->lines;
+        if(r->lines > s->max_lines) s->max_lines = r->lines;
+    }
+    s->mean_lines  = (double)lines / b->games;
+    s->mean_score  = (double)score / b->games;
+    s->mean_pieces = (double)s->pieces / b->games;
+}
+
+static void print_weights(const char *label, const TetrisAiConfig *cfg) {
+    printf("%s", label);
+    for(int f=0; f<TETRIS_AI_NUM_FEATURES; f++){
+        printf("%s%d", f ? "," : "", (int)cfg->weights[f]);
+    }
+    printf("\n");
+}
+
+static void print_summary(const Batch *b, const Summary *s) {
+    printf("%u partidas (%s%s), %d threads, profundidade %u: linhas media %.1f (min %u, max %u), "
+           "placar medio %.0f, pecas media %.1f\n",
+           (unsigned)b->games, b->randomizer == PIECE_RANDOM_BAG ? "7-bag" : "uniforme",
+           b->mode_20g ? ", 20G" : "",
+           b->threads, (unsigned)b->cfg.depth, s->mean_lines,
+           (unsigned)s->min_lines, (unsigned)s->max_lines, s->mean_score, s->mean_pieces);
+    printf("  %.2f s: %.1f partidas/s, %.0f pecas/s\n",
+           s->seconds, b->games / s->seconds, (double)s->pieces / s->seconds);
+}
+
+/** Descida coordenada nos pesos, maximizando a média de linhas. */
+static void tune(Batch *b, int iterations) {
+    Summary s;
+    run_batch(b, &s);
+    double best = s.mean_lines;
+    print_weights("inicio: pesos=", &b->cfg);
+    printf("  linhas media %.1f\n", best);
+
+    int32_t step[TETRIS_AI_NUM_FEATURES];
+    for(int f=0; f<TETRIS_AI_NUM_FEATURES; f++){
+        int32_t w = b->cfg.weights[f];
+        step[f] = (w < 0 ? -w : w) / 4;
+        if(step[f] < 50) step[f] = 50;
+    }
+
+    for(int it=1; it<=iterations; it++){
+        double t0 = now_s();
+        uint64_t pieces = 0;
+        for(int f=0; f<TETRIS_AI_NUM_FEATURES; f++){
+            bool improved = false;
+            for(int sign=1; sign>=-1 && !improved; sign-=2){
+                TetrisAiConfig saved = b->cfg;
+                b->cfg.weights[f] += sign * step[f];
+                run_batch(b, &s);
+                pieces += s.pieces;
+                if(s.mean_lines > best){
+                    best = s.mean_lines;
+                    improved = true;
+                } else {
+                    b->cfg = saved;
+                }
+            }
+            if(!improved && step[f] > 1) step[f] /= 2;
+        }
+        double dt = now_s() - t0;
+        printf("iteracao %d: linhas media %.1f (%.0f pecas/s) ", it, best, pieces / dt);
+        print_weights("pesos=", &b->cfg);
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "uso: %s [-n partidas] [-j threads] [-d profundidade] [-p max_pecas]\n"
+            "          [-s semente] [-w p0,p1,...] [-t iteracoes] [-u] [-g]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    static Batch b;
+    uint8_t depth = 1;
+    int iterations = 0;
+    const char *weights = NULL;
+
+    b.games = 200;
+    b.max_pieces = 5000;
+    b.seed = 1;
+    b.randomizer = PIECE_RANDOM_BAG;
+    b.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    int opt;
+    while((opt = getopt(argc, argv, "n:j:d:p:s:w:t:ugh")) != -1){
+        switch(opt){
+        case 'n': b.games = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'j': b.threads = atoi(optarg); break;
+        case 'd': depth = (uint8_t)atoi(optarg); break;
+        case 'p': b.max_pieces = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 's': b.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w': weights = optarg; break;
+        case 't': iterations = atoi(optarg); break;
+        case 'u': b.randomizer = PIECE_RANDOM_UNIFORM; break;
+        case 'g': b.mode_20g = true; break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(b.games == 0) b.games = 1;
+    if(b.threads < 1) b.threads = 1;
+    if(b.threads > MAX_THREADS) b.threads = MAX_THREADS;
+
+    tetris_ai_default_config(&b.cfg, depth);
+    if(weights){
+        char *p = (char *)weights;
+        for(int f=0; f<TETRIS_AI_NUM_FEATURES && *p; f++){
+            b.cfg.weights[f] = (int32_t)strtol(p, &p, 0);
+            if(*p == ',') p++;
+        }
+    }
+
+    b.results = calloc(b.games, sizeof(GameResult));
+    if(!b.results){
+        perror("calloc");
+        return 1;
+    }
+
+    if(iterations > 0){
+        tune(&b, iterations);
+    } else {
+        Summary s;
+        print_weights("pesos=", &b.cfg);
+        run_batch(&b, &s);
+        print_summary(&b, &s);
+    }
+    free(b.results);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * Player headless de logs de entrada (input_log.h): reexecuta a partida
+ * em tetris_update/tetris_apply_actions o mais rápido possível, sem
+ * sleeps, display ou som, e confere placar e hash finais.
+ *
+ *   tetris_replay <arquivo> [repeticoes]
+ *
+ * O arquivo pode ser o log binário ou a saída de texto do firmware; no
+ * segundo caso é usada a primeira linha "TLOG <hex>".
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "input_log.h"
+#include "tetris.h"
+#include "tetris_ai.h"
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if(!f) return NULL;
+    size_t cap = 1 << 16, n = 0;
+    uint8_t *buf = malloc(cap);
+    size_t r;
+    while(buf && (r = fread(buf + n, 1, cap - n, f)) > 0){
+        n += r;
+        if(n == cap){
+            cap *= 2;
+            buf = realloc(buf, cap);
+        }
+    }
+    fclose(f);
+    *len = n;
+    return buf;
+}
+
+static int hex_nibble(uint8_t c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/** Converte a primeira linha "TLOG <hex>" em binário, no próprio buffer. */
+static size_t decode_text_log(uint8_t *buf, size_t len) {
+    for(size_t i=0; i+5 <= len; i++){
+        if((i == 0 || buf[i-1] == '\n') && memcmp(&buf[i], "TLOG ", 5) == 0){
+            size_t out = 0;
+            for(size_t j=i+5; j+1 < len; j+=2){
+                int hi = hex_nibble(buf[j]), lo = hex_nibble(buf[j+1]);
+                if(hi < 0 || lo < 0) break;
+                buf[out++] = (uint8_t)(hi << 4 | lo);
+            }
+            return out;
+        }
+    }
+    return 0;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** Reexecuta o log inteiro; retorna o número de frames. */
+static uint32_t run(const uint8_t *buf, size_t len, TetrisGame *g) {
+    InputLogReader r;
+    input_log_reader_init(&r, buf, len);
+    tetris_init(g, r.header.seed, (PieceRandomizer)r.header.randomizer);
+    tetris_set_20g(g, r.header.flags & INPUT_LOG_FLAG_20G);
+
+    TetrisAi ai;
+    TetrisAiConfig cfg;
+    tetris_ai_default_config(&cfg, r.header.ai_depth);
+    tetris_ai_init(&ai, &cfg);
+
+    uint32_t frames = 0, dt;
+    uint8_t actions;
+    while(input_log_next(&r, &dt, &actions)){
+        tetris_update(g, dt);
+        if(r.header.ai_depth) tetris_ai_step(&ai, g);
+        tetris_apply_actions(g, actions);
+        tetris_take_events(g);
+        frames++;
+    }
+    return frames;
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2){
+        fprintf(stderr, "uso: %s <log> [repeticoes]\n", argv[0]);
+        return 2;
+    }
+    int reps = argc > 2 ? atoi(argv[2]) : 1000;
+    if(reps < 1) reps = 1;
+
+    size_t len = 0;
+    uint8_t *buf = read_file(argv[1], &len);
+    if(!buf){
+        perror(argv[1]);
+        return 2;
+    }
+    bool binary = len >= 5 && memcmp(buf, "TLOG", 4) == 0 && buf[4] == INPUT_LOG_VERSION;
+    if(!binary) len = decode_text_log(buf, len);
+
+    InputLogReader r;
+    if(!input_log_reader_init(&r, buf, len)){
+        fprintf(stderr, "%s: log invalido\n", argv[1]);
+        return 2;
+    }
+
+    TetrisGame g;
+    uint32_t frames = 0;
+    double t0 = now_s();
+    for(int i=0; i<reps; i++){
+        frames = run(buf, len, &g);
+    }
+    double elapsed = now_s() - t0;
+
+    uint32_t score = tetris_get_score(&g);
+    uint32_t hash  = tetris_hash(&g);
+    bool truncated = (r.header.flags & INPUT_LOG_FLAG_TRUNCATED) != 0;
+
+    printf("seed=%u %s frames=%u score=%u hash=%08x game_over=%d ai_depth=%u\n",
+           (unsigned)r.header.seed, r.header.randomizer == PIECE_RANDOM_BAG ? "7-bag" : "uniforme",
+           (unsigned)frames, (unsigned)score,
+           (unsigned)hash, tetris_is_game_over(&g), (unsigned)r.header.ai_depth);
+    printf("%.0f frames/s simulados (%d repeticoes, %.3f s)\n",
+           (double)frames * reps / elapsed, reps, elapsed);
+
+    if(frames != r.header.frames){
+        printf("ERRO: log tem %u frames, reexecutados %u\n",
+               (unsigned)r.header.frames, (unsigned)frames);
+        return 1;
+    }
+    if(truncated){
+        printf("AVISO: log truncado; placar/hash finais nao conferidos\n");
+        return 0;
+    }
+    if(score != r.header.final_score || hash != r.header.final_hash){
+        printf("ERRO: esperado score=%u hash=%08x\n",
+               (unsigned)r.header.final_score, (unsigned)r.header.final_hash);
+        return 1;
+    }
+    printf("OK: placar e hash conferem\n");
+    return 0;
+}